@@ -0,0 +1,212 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <cstdlib>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <SDL2/SDL.h>
+#include "Game.h"
+#include "Profiler.h"
+#include "FastMath.h"
+
+// Headless benchmark: dummy video/audio drivers, fixed timestep, seeded spawns
+// and a scripted walk through the demo map. Prints FPS and per-stage timings.
+//
+//   benchmark [--frames N] [--caco N] [--cyber N] [--soldier N] [--seed S] [--width W] [--height H]
+//             [--scale S] [--budget MS] [--csv path]
+//   benchmark --math N     FastMath against libm over N random angles, no window
+
+static std::vector<std::vector<int>> benchMap = {
+    {1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1},
+    {1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1},
+    {1,0,0,3,3,3,3,0,0,0,2,2,2,0,0,1},
+    {1,0,0,0,0,0,4,0,0,0,0,0,2,0,0,1},
+    {1,0,0,0,0,0,4,0,0,0,0,0,2,0,0,1},
+    {1,0,0,3,3,3,3,0,0,0,0,0,0,0,0,1},
+    {1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1},
+    {1,0,0,0,4,0,0,0,4,0,0,0,0,0,0,1},
+    {1,1,1,3,1,3,1,1,1,3,0,0,3,1,1,1},
+    {1,1,1,1,1,1,1,1,1,3,0,0,3,1,1,1},
+    {1,1,1,1,1,1,1,1,1,3,0,0,3,1,1,1},
+    {1,1,3,1,1,1,1,1,1,3,0,0,3,1,1,1},
+    {1,4,0,0,0,0,0,0,0,0,0,0,0,0,0,1},
+    {3,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1},
+    {1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1},
+    {1,0,0,2,0,0,0,0,0,3,4,0,4,3,0,1},
+    {1,0,0,5,0,0,0,0,0,0,3,0,3,0,0,1},
+    {1,0,0,2,0,0,0,0,0,0,0,0,0,0,0,1},
+    {1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1},
+    {3,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1},
+    {1,4,0,0,0,0,0,0,4,0,0,4,0,0,0,1},
+    {1,1,3,3,0,0,3,3,1,3,3,1,3,1,1,1},
+    {1,1,1,3,0,0,3,1,1,1,1,1,1,1,1,1},
+    {1,3,3,4,0,0,4,3,3,3,3,3,3,3,3,1},
+    {3,0,0,0,0,0,0,0,0,0,0,0,0,0,0,3},
+    {3,0,0,0,0,0,0,0,0,0,0,0,0,0,0,3},
+    {3,0,0,0,0,0,0,0,0,0,0,0,0,0,0,3},
+    {3,0,0,5,0,0,0,5,0,0,0,5,0,0,0,3},
+    {3,0,0,0,0,0,0,0,0,0,0,0,0,0,0,3},
+    {3,0,0,0,0,0,0,0,0,0,0,0,0,0,0,3},
+    {3,0,0,0,0,0,0,0,0,0,0,0,0,0,0,3},
+    {3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3}
+};
+
+// Deterministic camera/movement path: walk forward while sweeping the view,
+// strafe in alternating 2 second legs and fire every 0.75 s
+static InputState ScriptedInput(int frame)
+{
+    InputState in;
+    in.forward = (frame / 90) % 4 != 3;
+    in.backward = !in.forward;
+    in.left = (frame / 120) % 2 == 0;
+    in.right = !in.left;
+    in.turn = 0.012f;
+    in.lookUp = (frame / 60) % 4 == 0;
+    in.lookDown = (frame / 60) % 4 == 2;
+    in.fire = frame % 45 == 0;
+    if (frame % 600 == 0) in.weapon = (frame / 600) % 2;
+    return in;
+}
+
+static double MsSince(Uint64 start)
+{
+    return (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / (double)SDL_GetPerformanceFrequency();
+}
+
+static volatile float mathSink; // keeps the timed loops from being optimized away
+
+template<typename F>
+static void MathRow(const char* name, int n, F fn)
+{
+    float sink = 0;
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int i = 0; i < n; i++) sink += fn(i);
+    double ms = MsSince(start);
+    mathSink = sink;
+    std::cout << std::left << std::setw(16) << name << std::right << std::setw(10) << ms * 1e6 / n
+              << " ns/call" << std::endl;
+}
+
+static int RunMathBench(int n)
+{
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> angleDist(-200.0f, 200.0f), coordDist(-50.0f, 50.0f);
+    std::vector<float> a(n), y(n), x(n), s(n), c(n), out(n);
+    std::vector<FastMath::BAngle> b(n);
+    for (int i = 0; i < n; i++)
+    {
+        a[i] = angleDist(rng);
+        y[i] = coordDist(rng);
+        x[i] = coordDist(rng);
+        b[i] = (FastMath::BAngle)rng();
+    }
+
+    double errSin = 0, errCos = 0, errLut = 0, errAtan = 0;
+    for (int i = 0; i < n; i++)
+    {
+        errSin = std::max(errSin, std::fabs(FastMath::Sin(a[i]) - std::sin((double)a[i])));
+        errCos = std::max(errCos, std::fabs(FastMath::Cos(a[i]) - std::cos((double)a[i])));
+        errLut = std::max(errLut, std::fabs(FastMath::SinLUT(b[i]) - std::sin(b[i] * (2.0 * M_PI / 65536.0))));
+        errAtan = std::max(errAtan, std::fabs(FastMath::Atan2(y[i], x[i]) - std::atan2((double)y[i], (double)x[i])));
+    }
+    std::cout << "Max abs error: sin " << errSin << ", cos " << errCos
+              << ", sin LUT " << errLut << ", atan2 " << errAtan << std::endl;
+
+    std::cout << std::fixed << std::setprecision(2);
+    MathRow("std::sin", n, [&](int i) {return std::sin(a[i]);});
+    MathRow("FastMath::Sin", n, [&](int i) {return FastMath::Sin(a[i]);});
+    MathRow("FastMath::SinLUT", n, [&](int i) {return FastMath::SinLUT(b[i]);});
+    MathRow("std::atan2", n, [&](int i) {return std::atan2(y[i], x[i]);});
+    MathRow("FastMath::Atan2", n, [&](int i) {return FastMath::Atan2(y[i], x[i]);});
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    FastMath::SinCos(a.data(), s.data(), c.data(), n);
+    std::cout << std::left << std::setw(16) << "batch SinCos" << std::right << std::setw(10)
+              << MsSince(start) * 1e6 / n << " ns/pair" << std::endl;
+    start = SDL_GetPerformanceCounter();
+    FastMath::Atan2(y.data(), x.data(), out.data(), n);
+    std::cout << std::left << std::setw(16) << "batch Atan2" << std::right << std::setw(10)
+              << MsSince(start) * 1e6 / n << " ns/call" << std::endl;
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    int frames = 1000, caco = 8, cyber = 8, soldier = 0, width = 1366, height = 768;
+    unsigned int seed = 1234;
+    float scale = 1.0f, budgetMs = 0.0f;
+    std::string csvPath;
+
+    for (int i = 1; i < argc; i += 2)
+    {
+        std::string arg = argv[i];
+        if (i + 1 == argc)
+        {
+            std::cerr << "Missing value for option: " << arg << std::endl;
+            return 1;
+        }
+        if (arg == "--frames") frames = std::atoi(argv[i + 1]);
+        else if (arg == "--caco") caco = std::atoi(argv[i + 1]);
+        else if (arg == "--cyber") cyber = std::atoi(argv[i + 1]);
+        else if (arg == "--soldier") soldier = std::atoi(argv[i + 1]);
+        else if (arg == "--seed") seed = (unsigned int)std::atoi(argv[i + 1]);
+        else if (arg == "--width") width = std::atoi(argv[i + 1]);
+        else if (arg == "--height") height = std::atoi(argv[i + 1]);
+        else if (arg == "--scale") scale = (float)std::atof(argv[i + 1]);
+        else if (arg == "--budget") budgetMs = (float)std::atof(argv[i + 1]);
+        else if (arg == "--csv") csvPath = argv[i + 1];
+        else if (arg == "--math") return RunMathBench(std::max(1, std::atoi(argv[i + 1])));
+        else std::cerr << "Unknown option: " << arg << std::endl;
+    }
+
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+    SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+
+    Game game;
+    game.SetSeed(seed);
+    if (!game.Init("FPS_BENCHMARK", width, height, 0, 0, 0, benchMap))
+    {
+        std::cerr << "Benchmark: Game::Init failed" << std::endl;
+        return 1;
+    }
+    game.SetFixedTimestep(1.0f / 60.0f);
+    game.SetGodMode(true);
+    // Fixed render scale unless a frame budget is given, so runs stay comparable
+    game.SetRenderScale(scale);
+    if (budgetMs > 0) game.SetDynamicResolution(budgetMs);
+    // Cleared waves respawn as configured, so the enemy count never depends on kills
+    game.SetFixedWave(caco, cyber, soldier);
+    game.WaitForMap(); // the visibility table is built in the background, don't time the frames without it
+
+    std::cout << "Benchmark: " << frames << " frames, " << width << "x" << height
+              << ", " << caco << " cacodemons, " << cyber << " cyberdemons, "
+              << soldier << " soldiers, seed " << seed << std::endl;
+
+    Profiler::Instance().SetHistorySize(frames); // stats over the whole run, not the last 240 frames
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int f = 0; f < frames; f++) game.StepFrame(ScriptedInput(f));
+    Uint64 end = SDL_GetPerformanceCounter();
+
+    double seconds = (double)(end - start) / (double)SDL_GetPerformanceFrequency();
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Total " << seconds << " s, " << frames / seconds << " FPS, "
+              << seconds * 1000.0 / frames << " ms/frame, render scale " << game.GetRenderScale() << std::endl;
+
+    Profiler& prof = Profiler::Instance();
+    std::cout << std::left << std::setw(14) << "stage" << std::right
+              << std::setw(10) << "min ms" << std::setw(10) << "avg ms"
+              << std::setw(10) << "p99 ms" << std::setw(10) << "max ms" << std::endl;
+    for (int i = 0; i < prof.GetStageCount(); i++)
+    {
+        ProfileStats st = prof.GetStats(i);
+        std::cout << std::left << std::setw(14) << prof.GetStageName(i) << std::right
+                  << std::setw(10) << st.minMs << std::setw(10) << st.avgMs
+                  << std::setw(10) << st.p99Ms << std::setw(10) << st.maxMs << std::endl;
+    }
+    if (!csvPath.empty()) prof.WriteCSV(csvPath);
+
+    game.Clean();
+    return 0;
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_mixer.h>
+#include <string>
+#include <vector>
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include "ThreadPool.h"
+
+enum AssetKind {ASSET_IMAGE, ASSET_SHEET, ASSET_SOUND, ASSET_MUSIC};
+
+// CPU-side result of one decode; the group's commit takes ownership of it
+struct Asset
+{
+    AssetKind kind;
+    std::string path;
+    SDL_Surface* pixels = nullptr; // ARGB8888, images and sheets
+    Mix_Chunk* chunk = nullptr;
+    Mix_Music* music = nullptr;
+    float decodeMs = 0.0f;
+};
+
+// Decodes queued files on a worker pool while the calling thread keeps drawing. Files are queued
+// in groups; a group's commit runs on the calling thread (CommitReady) once all of its files are
+// decoded, strictly in queue order, so texture indices come out the same as with serial loading.
+class AssetLoader
+{
+private:
+    struct Group
+    {
+        std::vector<Asset> assets;
+        std::function<void(std::vector<Asset>&)> commit;
+        std::atomic<int> remaining{0};
+        float commitMs = 0.0f;
+    };
+    std::vector<std::unique_ptr<Group>> groups;
+    std::vector<std::pair<Group*, int>> work; // flat list of (group, asset) for the workers
+    size_t nextGroup = 0;
+    std::atomic<int> decoded{0};
+    ThreadPool pool;
+    std::thread runner;
+    Uint64 startCounter = 0;
+    float wallMs = 0.0f;
+    static void Decode(Asset& a);
+public:
+    static SDL_Surface* DecodeImage(const std::string& path);
+    static SDL_Surface* DecodeSheet(const std::string& path); // a file, or a folder of frames stitched left to right
+    static std::vector<std::string> ListFiles(const std::string& folder, const std::vector<std::string>& exts = {}); // sorted
+
+    void Queue(AssetKind kind, const std::vector<std::string>& paths, std::function<void(std::vector<Asset>&)> commit);
+    void Start();
+    bool CommitReady(); // runs the commits that are due, true once every group is committed
+    float GetProgress() const; // decoded fraction, 0..1
+    void Finish();      // waits for the workers and stops them, prints per-asset timings
+};
@@ -2,27 +2,71 @@
 #include <SDL2/SDL_mixer.h>
 #include <string>
 #include <map>
+#include <vector>
 #include <iostream>
 #include <filesystem>
+#include "AssetLoader.h"
+#define AUDIO_VOICES 16          // mixer channels for PlaySound, the exclusive channel comes on top
+#define AUDIO_MAX_INSTANCES 4    // default cap of one sound playing at once
+#define INVALID_SOUND -1
 namespace fs = std::filesystem;
 
+typedef int SoundHandle; // index into the loaded sounds, resolved once with GetSound
+
+// Sound effects play through a fixed pool of voices. Play only queues a request, repeats of the
+// same sound in one tick collapse into one; Flush (once per simulation tick) starts them by
+// priority. A sound at its instance cap restarts its oldest voice, and when every voice is busy
+// the lowest-priority, oldest one is stolen unless it outranks the new sound.
 class Audio
 {
 private:
+    struct Sound
+    {
+        Mix_Chunk* chunk;
+        int priority;
+        int maxInstances;
+        unsigned int queuedTick; // dedup: last tick this sound was queued in
+    };
+    struct Voice
+    {
+        SoundHandle sound = INVALID_SOUND;
+        int priority = 0;
+        unsigned int started = 0; // start order, smaller is older
+    };
+    struct Request
+    {
+        SoundHandle sound;
+        int loops;
+    };
     std::map<std::string, Mix_Music*> musicTracks;
-    std::map<std::string, Mix_Chunk*> soundEffects;
+    std::map<std::string, SoundHandle> soundNames;
+    std::vector<Sound> sounds;
+    std::vector<Voice> voices; // voices[i] plays on mixer channel FIRST_VOICE + i
+    std::vector<Request> pending;
+    unsigned int tick = 1;
+    unsigned int startCount = 0;
 
     std::string GetFilenameWithoutExtension(const std::string& path);
+    int PickVoice(SoundHandle sound, int priority);
     static const int EXCLUSIVE_CHANNEL = 0;
+    static const int FIRST_VOICE = 1;
 public:
-    bool Init();
+    bool Init(int voiceCount = AUDIO_VOICES);
 
     void LoadMusic(const std::string& folderPath);
 
     void LoadSound(const std::string& folderPath);
 
+    // Already decoded, the audio manager takes ownership; the name is the file stem
+    void AddMusic(const std::string& name, Mix_Music* music);
+    void AddSound(const std::string& name, Mix_Chunk* sound);
+
+    SoundHandle GetSound(const std::string& name) const; // INVALID_SOUND if it was not loaded
+    void SetSoundParams(SoundHandle sound, int priority, int maxInstances);
+
     void PlayMusic(const std::string& name, int loops = -1);
-    void PlaySound(const std::string& name, int loops = 0);
-    void PlayExclusiveSound(const std::string& name, int loops = 0);
+    void PlaySound(SoundHandle sound, int loops = 0);
+    void PlayExclusiveSound(SoundHandle sound, int loops = 0);
+    void Flush(); // start this tick's queued sounds
     void CleanUp();
 };
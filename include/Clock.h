@@ -1,13 +1,22 @@
 #pragma once
 #include <SDL2/SDL.h>
 #include <algorithm>
+#define DEFAULT_TICK_RATE 60
+#define MAX_FRAME_TIME 0.25f // longest frame fed to the accumulator, so a stall cannot snowball into more ticks
+
+// Real frame timing plus a fixed-step accumulator for the simulation.
+// Every frame: tick() once, then run a simulation step for each stepTick() that returns true.
 class Clock
 {
 private:
     Uint64 lastCounter;
     Uint64 frequency;
-    float deltaTime;
+    float frameTime;
+    float workTime = 0.0f; // last frame without the limiter's sleep
     float fps;
+    float tickDelta = 1.0f / DEFAULT_TICK_RATE;
+    float accumulator = 0.0f;
+    float fixedDelta = 0.0f;
 
 public:
     Clock();
@@ -16,8 +25,31 @@ public:
     void tick(int targetFPS = 0);
 
 
+    // Simulation step length, what movement and AI integrate with
     float getDeltaTime() const;
 
 
+    float getFrameTime() const;
+
+
+    // Busy part of the last frame, what the dynamic resolution controller budgets
+    float getWorkTime() const;
+
+
     float getFPS() const;
+
+
+    void setTickRate(int hz);
+
+
+    // Consumes one simulation step from the accumulator if a whole one is available
+    bool stepTick();
+
+
+    // Fraction of a step left in the accumulator, for blending the last two simulated poses
+    float getAlpha() const;
+
+
+    // Non-zero: every tick reports exactly dt and never sleeps (headless benchmark)
+    void setFixedDelta(float dt);
 };
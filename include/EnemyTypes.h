@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdint>
+#define STATE_COUNT 6 // DEFAULT, IDLE, WALK, ATTACK, PAIN, DEATH
+
+enum EnemyType : uint8_t
+{
+    ENEMY_CACODEMON,
+    ENEMY_CYBERDEMON,
+    ENEMY_SOLDIER,
+    ENEMY_TYPE_COUNT
+};
+
+// Everything that differs between enemy kinds. Adding a kind is a new row here plus its folder in res/sprites.
+struct EnemyTypeInfo
+{
+    const char* name;                  // folder under res/sprites
+    const char* sheets[STATE_COUNT];   // per state: a sprite sheet file, or a folder of single frames stitched at load
+    int frames[STATE_COUNT];           // frames per state sheet; IDLE holds the 8 view directions
+    int frameDelay[STATE_COUNT];       // simulation ticks per animation frame
+    int defaultState;
+    float hp, speed, rotSpeed, damage, range;
+};
+
+constexpr EnemyTypeInfo ENEMY_TYPES[ENEMY_TYPE_COUNT] =
+{
+    {"cacodemon",
+     {"0DEFAULT.png", "1IDLE.png", "2WALK.png", "3ATTACK.png", "4PAIN.png", "5DEATH.png"},
+     {1, 8, 3, 5, 2, 6}, {0, 0, 14, 8, 15, 9}, 1, 100.0f, 1.0f, 3.0f, 0.2f, 1.5f},
+    {"cyberdemon",
+     {"0DEFAULT.png", "1IDLE.png", "2WALK.png", "3ATTACK.png", "4PAIN.png", "5DEATH.png"},
+     {1, 8, 4, 2, 2, 9}, {0, 0, 14, 8, 15, 9}, 1, 100.0f, 1.0f, 3.0f, 0.2f, 5.0f},
+    {"soldier",
+     {"0.png", "idle", "walk", "attack", "pain", "death"},
+     {1, 8, 4, 2, 1, 9}, {0, 0, 12, 10, 15, 8}, 1, 60.0f, 1.5f, 3.0f, 0.1f, 4.0f},
+};
+
+inline const EnemyTypeInfo& GetEnemyType(int type) {return ENEMY_TYPES[type];}
@@ -11,6 +11,10 @@
 #include "Physics.h"
 #include "Interface.h"
 #include "Audio.h"
+#include "Profiler.h"
+#include "WorldSnapshot.h"
+#include "ResolutionController.h"
+#include "AssetLoader.h"
 #define Forward -1
 #define Backward -2
 #define Right -3
@@ -26,36 +30,51 @@ private:
     Player player;
     Physics physicsManager;
     Audio audioManager;
-    std::vector<Sprites> sprites;
+    Sprites sprites;
+    SnapshotBuffer snapshots;
+    ResolutionController resolution;
+    AssetLoader assets;
+    const WorldSnapshot* renderView = nullptr;
+    int enemyTexBase[ENEMY_TYPE_COUNT]; // first texture of each enemy type, -1 until PreloadSprites or if a sheet failed
 
 public:
+    Engine();
+
     // Initialization
     bool InitRenderer(const char* title, int w, int h, bool fullscreen, bool resizable);
     bool InitUI();
     bool InitAudio();
     bool InitMap(const std::vector<std::vector<int>>& miniMap);
+    void WaitForMap(); // until the map's background precompute is done
     bool InitPlayer(std::pair<float, float> pos, float angle, float speed, float hp);
     void SetupConnections();
 
     // Rendering
+    void BeginRenderFrame(); // picks up the latest published snapshot and the render scale for this frame
+    void SetDynamicResolution(float budgetMs); // <= 0 turns the controller off
+    void SetRenderScale(float scale);          // fixed scale, turns the controller off
+    float GetRenderScale() const;
     void ClearScreen();
     void RenderBackground();
     void RenderRayCasting();
     void RenderSprites();
     void Render2DMap(float scale);
-    void Render2DPlayer(float scale);
-    void Render2DSprites(float scale);
+    void Render2DMarkers(float scale);
     void RenderWeapon();
     void RenderCrosshair();
     void RenderHpEffect();
+    void RenderHud(); // FPS, round and score
     void RenderEndScreen(int round, int maxScore);
+    void RenderProfiler();
     void DisplayFrame();
 
     // Audio
     void LoadSounds(const std::string& path);
     void LoadMusic(const std::string& path);
-    void PlaySound(const std::string& name, int loops);
-    void PlayExclusiveSound(const std::string& name, int loops);
+    SoundHandle GetSound(const std::string& name) const; // resolve once, after LoadSounds
+    void SetSoundParams(SoundHandle sound, int priority, int maxInstances);
+    void PlaySound(SoundHandle sound, int loops); // queued, started at the next tick boundary
+    void PlayExclusiveSound(SoundHandle sound, int loops);
     void PlayMusic(const std::string& name, int loops);
 
     // UI/Weapons
@@ -68,6 +87,7 @@ public:
     // Textures
     void LoadBackgroundTexture();
     void LoadTextures(const std::string& path);
+    void FinishLoading(); // Load* and PreloadSprites only queue files, this decodes them in parallel and waits
     void ClearTextures();
     int GetTextureSize();
 
@@ -78,26 +98,26 @@ public:
     float GetPlayerHp() const;
     void SetPlayerHp(float hp);
     void SetPlayerPos(std::pair<float, float> pos);
-    void RotatePlayer(float angle);
+    void RotatePlayer(float angle, bool blend = true);
     void PlayerLookUp();
     void PlayerLookDown();
     void PlayerTakeDamage(float damage);
 
     // Physics/Movement
     void MovePlayer(int dir);
-    void MoveSprite(int index, int dir);
-    Sprites* PerformPlayerRaycast();
+    void MoveSprites(); // apply the velocities the AI set this tick
+    void PerformPlayerHitscan(int rays, float spread, std::vector<HitscanResult>& out);
     bool PerformSpriteRaycast(int index, float fov, float depth);
+    void PerformSpriteSight(float fov, float depth, std::vector<uint8_t>& out); // all sprites at once
     void UpdateAllSpritesPhysics();
 
     // Sprites
-    void AddSprite(const std::string& name, std::pair<int, int> pos, float angle,
-                   float speed, float rotSpeed, bool rigid, bool visible,
-                   int defaultState, float damage, float range);
+    int AddSprite(int type, std::pair<float, float> pos, float angle = 0.0f);
+    void PreloadSprites(int type);
     void ClearSprites();
+    void PublishSnapshot(int round, int score); // simulation side: copy the world for the renderer
     int GetSpriteCount() const;
-    Sprites& GetSprite(int index);
-    const std::vector<Sprites>& GetSprites() const;
+    Sprites& GetSprites();
     void UpdateSpriteStates();
     void UpdateSpriteAnimations();
 
@@ -105,10 +125,19 @@ public:
     bool IsWall(std::pair<int, int> pos) const;
     int GetMapRows() const;
     int GetMapCols() const;
+    const Map& GetMap() const;
+
+    // Profiler
+    void EndProfilerFrame();
+    void ToggleProfilerOverlay();
+    void WriteProfile(const std::string& path);
 
     // Clock
     void Tick(float targetFPS);
+    bool StepSimulation(); // true while a fixed tick is due, saves poses for interpolation
+    void SetTickRate(int hz);
     float GetDeltaTime() const;
+    void SetFixedDelta(float dt);
 
     // Cleanup
     void Cleanup();
@@ -0,0 +1,76 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+
+// Fast angle math for the per-ray, per-sprite and per-agent paths.
+// Max error against double-precision libm for angles in [-200, 200] rad (see `benchmark --math`):
+//   Sin / Cos      5e-7    degree-11 polynomial after reduction to [-pi/2, pi/2]
+//   SinLUT/CosLUT  4e-7    4096-entry table with linear interpolation, binary angles only
+//   Atan2          2e-6    rad, degree-11 odd polynomial on [0, 1] plus octant fix-up
+// The batch versions use SSE2 when available and return the same values as the scalar ones.
+namespace FastMath
+{
+    constexpr float PI_F = 3.14159265f;
+    constexpr float TWO_PI_F = 6.28318531f;
+    constexpr float HALF_PI_F = 1.57079633f;
+    constexpr float INV_TWO_PI_F = 0.159154943f;
+    constexpr float TWO_PI_HI = 6.28125f; // exact in float, k * TWO_PI_HI has no rounding error
+    constexpr float TWO_PI_LO = 1.93530717e-3f;
+
+    // Binary angle: a full turn is 65536 units, so wraparound is plain integer overflow
+    typedef uint16_t BAngle;
+    constexpr float RAD_TO_BANGLE = 65536.0f / TWO_PI_F;
+    constexpr float BANGLE_TO_RAD = TWO_PI_F / 65536.0f;
+    constexpr int SIN_TABLE_BITS = 12;
+
+    extern const float* sinTable; // (1 << SIN_TABLE_BITS) + 1 entries covering one turn
+
+    inline BAngle ToBAngle(float rad) {return (BAngle)(int32_t)(rad * RAD_TO_BANGLE);}
+    inline float FromBAngle(BAngle a) {return (int16_t)a * BANGLE_TO_RAD;} // in [-pi, pi)
+
+    inline float SinLUT(BAngle a)
+    {
+        constexpr int shift = 16 - SIN_TABLE_BITS;
+        int i = a >> shift;
+        float t = (a & ((1 << shift) - 1)) * (1.0f / (1 << shift));
+        return sinTable[i] + (sinTable[i + 1] - sinTable[i]) * t;
+    }
+    inline float CosLUT(BAngle a) {return SinLUT((BAngle)(a + 16384));}
+
+    // Wrap to [-pi, pi)
+    inline float WrapAngle(float a)
+    {
+        float k = std::floor((a + PI_F) * INV_TWO_PI_F);
+        return (a - k * TWO_PI_HI) - k * TWO_PI_LO;
+    }
+
+    inline float Sin(float x)
+    {
+        x = WrapAngle(x);
+        // Fold into [-pi/2, pi/2] using sin(pi - x) = sin(x)
+        if (x > HALF_PI_F) x = PI_F - x;
+        else if (x < -HALF_PI_F) x = -PI_F - x;
+        float x2 = x * x;
+        return x * (1.0f + x2 * (-1.6666667e-1f + x2 * (8.3333331e-3f + x2 * (-1.9841270e-4f +
+               x2 * (2.7557319e-6f + x2 * -2.5052108e-8f)))));
+    }
+    inline float Cos(float x) {return Sin(WrapAngle(x) + HALF_PI_F);}
+
+    inline float Atan2(float y, float x)
+    {
+        float ax = std::fabs(x), ay = std::fabs(y);
+        float mx = ax > ay ? ax : ay;
+        float mn = ax > ay ? ay : ax;
+        float z = mx > 0.0f ? mn / mx : 0.0f;
+        float z2 = z * z;
+        float r = z * (0.99997726f + z2 * (-0.33262347f + z2 * (0.19354346f + z2 * (-0.11643287f +
+                  z2 * (0.05265332f + z2 * -0.01172120f)))));
+        if (ay > ax) r = HALF_PI_F - r;
+        if (x < 0.0f) r = PI_F - r;
+        return y < 0.0f ? -r : r;
+    }
+
+    // Batch versions, arrays may alias
+    void SinCos(const float* angles, float* sinOut, float* cosOut, int count);
+    void Atan2(const float* y, const float* x, float* out, int count);
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include "Map.h"
+
+// Shared breadth-first distance field toward one target cell (the player).
+// Rebuilt only when the target changes cell; every enemy then steps to the
+// neighbour with the lowest distance instead of running its own search.
+class FlowField
+{
+private:
+    const Map* map = nullptr;
+    int rows = 0, cols = 0;
+    int target = -1;
+    std::vector<int> dist;  // steps to target, -1 when unreachable
+    std::vector<int> next;  // cell id to move to, -1 at the target or when unreachable
+    std::vector<int> queue;
+
+    void Rebuild();
+public:
+    void Init(const Map& mp);
+    bool Update(std::pair<int, int> targetCell); // true when the field was rebuilt
+    int GetDistance(int row, int col) const;
+    bool GetNextCell(int row, int col, std::pair<int, int>& cell) const;
+};
@@ -7,17 +7,21 @@
 #include <numeric>
 #include <chrono>
 #include <random>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include "Engine.h"
+#include "FlowField.h"
 
-struct Node {
-    int y, x;
-    int g, h;
-    Node* parent;
-
-    Node(int _y, int _x, int _g, int _h, Node* _parent)
-        : y(_y), x(_x), g(_g), h(_h), parent(_parent) {}
-
-    int f() const { return g + h; }
+// One frame of player input, read from the keyboard or supplied by a script
+struct InputState
+{
+    bool forward = false, backward = false, left = false, right = false;
+    bool turnLeft = false, turnRight = false;
+    bool lookUp = false, lookDown = false;
+    float turn = 0.0f; // extra rotation in radians per simulation tick
+    bool fire = false;
+    int weapon = -1;   // -1 keeps the current weapon
 };
 
 class Game
@@ -36,11 +40,32 @@ private:
     int Round;
     int maxScore;
     bool MouseClick;
+    bool godMode = false;
+    bool fixedSeed = false;
+    bool fixedWave = false; // respawn the same wave instead of advancing rounds
+    int waveCaco = 0, waveCyber = 0, waveSoldier = 0;
+    InputState input;
+    std::mt19937 rng;
+    FlowField flowField;
+    std::vector<uint8_t> sightMask; // per sprite, filled at the start of UpdateAI
+    std::vector<HitscanResult> shotHits; // one per ray of the last shot
+    SoundHandle sndShotgun = INVALID_SOUND;
+    SoundHandle sndPlayerPain = INVALID_SOUND;
+
+    // Simulation thread, runs the ticks of frame N + 1 while the main thread renders frame N
+    std::thread simThread;
+    std::mutex simMtx;
+    std::condition_variable simCv;
+    bool simRequested = false;
+    bool simQuit = false;
 
     // Helper methods
     std::pair<float, float> GetRandomEmptyPosF();
-    int CalculateHeuristic(std::pair<int, int> a, std::pair<int, int> b);
-    std::vector<std::pair<int, int>> FindPathAStar(std::pair<int, int> start, std::pair<int, int> end);
+    void ReadKeyboard();
+    void Simulate();
+    void SimulationLoop();
+    void StartSimulation();
+    void FinishSimulation();
 
 public:
     bool Init(const char* title, int w, int h, bool fullscreen, bool resizable, float FPS, const std::vector<std::vector<int>>& miniMap);
@@ -50,6 +75,18 @@ public:
     void Clean();
     void Run();
     void RebuildData();
-    void AddSprite(std::string name, std::pair<int, int> pos, float a, float s, float rs, bool vs, bool Rigid, int defaultState, float dm, float rag);
+    void StartWave(int cacodemons, int cyberdemons, int soldiers = 0);
+
+    // Headless driving (benchmark): fixed dt, seeded spawns, scripted input
+    void SetFixedTimestep(float dt);
+    void SetSeed(unsigned int seed);
+    void SetGodMode(bool on);
+    void WaitForMap();
+    void SetFixedWave(int cacodemons, int cyberdemons, int soldiers); // starts it, and restarts it whenever it is cleared
+    void SetDynamicResolution(float budgetMs);
+    void SetRenderScale(float scale);
+    float GetRenderScale() const;
+    void StepFrame(const InputState& in);
+    void AddSprite(int type, std::pair<float, float> pos);
     void UpdateAI();
 };
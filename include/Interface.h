@@ -6,15 +6,20 @@
 #include <iostream>
 #include <filesystem>
 #include <algorithm>
+#include "AssetLoader.h"
 #define SHOTGUN_TOTAL_FRAMES 6
 #define SHOTGUN_FRAME_DELAY 7
 #define SHOTGUN_X_OFFSET 0
 #define SHOTGUN_SCALE 0.35f
+#define SHOTGUN_PELLETS 7
+#define SHOTGUN_SPREAD 0.08f // rad either side of the crosshair
+#define SHOTGUN_DAMAGE 6     // per pellet
 
 #define HANDGUN_TOTAL_FRAMES 4
 #define HANDGUN_FRAME_DELAY 5
 #define HANDGUN_X_OFFSET 450
 #define HANDGUN_SCALE 1.0f
+#define HANDGUN_DAMAGE 20
 namespace fs = std::filesystem;
 class Interface;
 
@@ -22,11 +27,19 @@ struct WeaponInfo
 {
     int startIndex;
     int totalFrames;
-    int frameDelay;
+    int frameDelay; // simulation ticks per animation frame
     int screenXOffset;
     float scale;
 };
 
+// Weapon animation state as seen by the renderer
+struct WeaponView
+{
+    unsigned int index = 0;
+    int state = 0; // 0 idle, 1 firing
+    int frame = 0;
+};
+
 class Interface
 {
 private:
@@ -43,16 +56,17 @@ private:
     int screenWidth;
     int screenHeight;
 
-    void LoadTex(const std::string& fullPath);
-
 public:
     void GetRenderInfo(SDL_Renderer* rd, int w, int h);
     bool Init();
+    static std::vector<std::string> GetWeaponFiles(const std::string& weaponName); // idle frame, then the firing sheet
     void LoadWeapon(const std::string& weaponName, int totalFrames, int frameDelay, int xOffset, float scale);
+    void AddWeapon(const std::vector<SDL_Surface*>& frames, int totalFrames, int frameDelay, int xOffset, float scale); // takes the surfaces
     void ChangeWeapon(int index);
     void RunShootAni();
     void UpdateAnimation();
-    void RenderWeapon();
+    WeaponView GetView() const;
+    void RenderWeapon(const WeaponView& view);
     void RenderCrosshair();
     void CleanUp();
     bool IsAniDone() const { return WEAPON_AniDone; }
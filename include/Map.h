@@ -1,16 +1,43 @@
 #pragma once
-#include <map>
 #include <vector>
+#include <utility>
+#include <cstdint>
+#include "PvsTable.h"
+#define CELL_TEX_MASK 0x00FF
+#define CELL_WALL     0x0100
+
+struct RayHit
+{
+    float distance; // in units of the ray direction, perpendicular distance for camera-plane rays
+    int row, col;   // hit cell
+    bool vertical;  // true when a vertical grid line (x = const) was crossed
+    int tex;
+    float wallX;    // hit position along the wall face in [0, 1)
+};
+
+// Row-major tile grid: cells[row * cols + col], texture id in the low byte, flags above it.
 class Map
 {
 private:
     int rows, cols;
-    std::map<std::pair<int, int>, int> worldMap;
+    std::vector<uint16_t> cells;
+    PvsTable pvs; // rebuilt in the background by Init, the map is static afterwards
+    int version = 0; // bumped by Init so caches of the map can tell it changed
 public:
     bool Init(const std::vector<std::vector<int>>& miniMap);
-    std::map<std::pair<int, int>, int>* GetMap();
+    bool InBounds(int row, int col) const;
     bool FindPos(std::pair<int, int> pos) const;
-    int GetVal(std::pair<int, int> pos);
+    int GetVal(std::pair<int, int> pos) const;
+    uint16_t GetCell(int row, int col) const;
+    const std::vector<uint16_t>& GetCells() const;
     int GetRow() const;
     int GetCol() const;
+    bool CastRay(float px, float py, float dirX, float dirY, RayHit& hit) const;
+    const PvsTable& GetPvs() const;
+    void WaitPvs();
+    int GetVersion() const;
+
+    // Unchecked accessors for inner loops, caller guarantees InBounds(row, col)
+    bool IsWallUnchecked(int row, int col) const {return cells[row * cols + col] & CELL_WALL;}
+    int GetTexUnchecked(int row, int col) const {return cells[row * cols + col] & CELL_TEX_MASK;}
 };
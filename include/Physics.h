@@ -1,35 +1,54 @@
 #pragma once
 #include <cmath>
 #include <vector>
-#include <list>
 #include <memory.h>
 #include "Map.h"
 #include "Player.h"
 #include "Sprites.h"
 #include "Clock.h"
+#include "SpatialGrid.h"
+#include "SightGrid.h"
+#include "FastMath.h"
 #define Forward -1
 #define Backward -2
 #define Right -3
 #define Left -4
 #define PI 3.14159265f
 #define INF 10000000.0f
+#define SPT_RADIUS 0.6f
+#define GRID_SLACK 0.5f // how far a sprite may drift from its bucket between rebuilds
+#define HIT_RADIUS 0.35f // sprite body for hitscan, HIT_RADIUS + GRID_SLACK must stay below one tile
+#define HITSCAN_RANGE 64.0f
+
+struct HitscanResult
+{
+    int sprite;     // index of the sprite hit, -1 for a wall or nothing
+    float distance; // along the ray, HITSCAN_RANGE (or maxDist) when nothing was hit
+    float x, y;     // hit point
+};
 
 class Physics
 {
 private:
-    std::vector<Sprites>* PhySptList; // list of physics entity
-    std::map<std::pair<int, int>, std::list<Sprites*>> SptManager; // Sprites manager on map
+    Sprites* PhySptList; // list of physics entity
+    SpatialGrid SptGrid; // sprite indices bucketed by map tile, rebuilt every tick
+    std::vector<int> queryBuf; // scratch for grid queries
+    SightGrid sightGrid; // bit-packed walls for line-of-sight batches
+    std::vector<int> sightIdx; // sprites that pass the PVS test, compacted for the sight batch
+    std::vector<float> sightX, sightY, sightA;
+    std::vector<uint8_t> sightOut;
+    std::vector<int> hitStamp; // per sprite, last hitscan that tested it
+    int stampId = 0;
+    std::vector<float> rayAngles, rayCos, raySin;
     Player* mainPlayer; // get player state
     Map* mainMap; // get map
     Clock* MyClock; // get delta time
-    float RayVert(float angle, float px, float py, float& xvert, float& yvert);
-    float RayHor(float angle, float px, float py, float& xhor, float& yhor);
     template<typename T>
     std::pair<float, float> MoveEnt(T& ent, int type)
     {
         float dt = MyClock->getDeltaTime();
-        float sin_a = std::sin(ent.GetA());
-        float cos_a = std::cos(ent.GetA());
+        float sin_a = FastMath::Sin(ent.GetA());
+        float cos_a = FastMath::Cos(ent.GetA());
         float dx = 0, dy = 0;
         float speed = ent.GetS();
         float speed_sin = speed * sin_a;
@@ -60,14 +79,18 @@ private:
     }
 
 public:
-    void ImportEntity(Map& mp, Player& py, Clock& clk, std::vector<Sprites>& psl);
+    void ImportEntity(Map& mp, Player& py, Clock& clk, Sprites& psl);
     void UpdateAllSpt();
-    void UpdateSpt(Sprites& spt);
-    void MoveSpt(int index, int type);
+    void MoveAllSpt(); // integrate sprite velocities for one tick
     void MovePly(int type);
-    Sprites* Praycast(); // ray from player
+    bool Hitscan(float ox, float oy, float dirX, float dirY, float maxDist, HitscanResult& hit); // dir is unit length
+    void HitscanBatch(float ox, float oy, const float* angles, int count, float maxDist, HitscanResult* out);
+    void PlayerHitscan(int rays, float spread, std::vector<HitscanResult>& out); // rays fanned over +-spread rad
     bool Sraycast(int index, float SptFov, float maxDepth); // ray from sprite
+    void SraycastAll(float SptFov, float maxDepth, std::vector<uint8_t>& out); // out[i] = sprite i sees the player
     bool Check_wall(float x, float y);
     bool CheckEnt(float ax, float ay, float bx, float by);
-    std::vector<Sprites*> CheckSptCollision(float newX, float newY, Sprites* spt);
+    bool CheckSptCollision(float newX, float newY, int self); // self = -1 for the player
+    void QuerySprites(float x, float y, float radius, std::vector<int>& out) const;
+    void QuerySprites(float minX, float minY, float maxX, float maxY, std::vector<int>& out) const;
 };
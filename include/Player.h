@@ -8,6 +8,7 @@ class Player
 {
 private:
     float Px, Py;
+    float prevX, prevY, prevAngle; // pose at the start of the current simulation tick
     float Pangle;
     float Pspeed;
     float Ppitch;
@@ -17,7 +18,11 @@ private:
 public:
     bool Init(std::pair<float, float> pos, float a, float s, float hp);
     void ChangePos(std::pair<float, float> pos);
-    void Rotate(float deltaAngle);
+    void SavePose();
+    float GetPrevX() const;
+    float GetPrevY() const;
+    float GetPrevA() const;
+    void Rotate(float deltaAngle, bool blend = true); // unblended turns (mouse) move the previous pose too
     void LookUp();
     void LookDown();
     void TakeDamage(float amount);
@@ -0,0 +1,69 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <string>
+#include <vector>
+#include <mutex>
+#define PROFILE_HISTORY 240 // default frames kept per stage for min/avg/p99
+
+class TextRenderer;
+
+// Per-stage frame timer. Stages accumulate time during a frame through
+// PROFILE_SCOPE, EndFrame() pushes the frame's totals into a rolling history.
+// Scopes may run on the simulation and render threads at once; stats and CSV are
+// read from the main thread while the simulation is idle.
+struct ProfileStats
+{
+    float minMs, avgMs, p99Ms, maxMs;
+};
+
+class Profiler
+{
+private:
+    struct Stage
+    {
+        std::string name;
+        float frameMs = 0.0f;
+        std::vector<float> history;
+        int head = 0;
+        int count = 0;
+    };
+    std::vector<Stage> stages;
+    float msPerTick;
+    int historySize = PROFILE_HISTORY;
+    bool overlay = false;
+    std::mutex mtx;
+    Profiler();
+public:
+    static Profiler& Instance();
+    int Register(const char* name);
+    void AddTime(int id, Uint64 ticks);
+    void EndFrame();
+    void SetHistorySize(int frames);
+    ProfileStats GetStats(int id) const;
+    int GetStageCount() const;
+    const std::string& GetStageName(int id) const;
+    void ToggleOverlay();
+    bool IsOverlayOn() const;
+    void RenderOverlay(SDL_Renderer* renderer, int x, int y, TextRenderer* labels = nullptr); // labels go left of x
+    bool WriteCSV(const std::string& path) const;
+};
+
+class ProfileScope
+{
+private:
+    int id;
+    Uint64 start;
+public:
+    explicit ProfileScope(int stageId) : id(stageId), start(SDL_GetPerformanceCounter()) {}
+    ~ProfileScope() {Profiler::Instance().AddTime(id, SDL_GetPerformanceCounter() - start);}
+};
+
+#ifdef NO_PROFILER
+#define PROFILE_SCOPE(name)
+#else
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(name) \
+    static const int PROFILE_CONCAT(profStage_, __LINE__) = Profiler::Instance().Register(name); \
+    ProfileScope PROFILE_CONCAT(profScope_, __LINE__)(PROFILE_CONCAT(profStage_, __LINE__))
+#endif
@@ -0,0 +1,37 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <thread>
+#include <atomic>
+#define PVS_RADIUS 20 // cells, covers the AI sight depth; pairs farther apart in either axis are always reported visible
+#define PVS_THREADS 2 // build threads, kept small since the render and loader pools run at the same time
+
+class Map;
+
+// Potentially visible set: per floor cell, one bit for every cell of the (2 * PVS_RADIUS + 1)^2
+// window around it, so the build scales with the map area. Build copies the walls and fills the
+// table on a background thread; until it is done every query answers "visible".
+// A clear bit means no segment from any point of one cell to any point of the other stays on
+// floor tiles, so callers may skip the exact ray; a set bit proves nothing.
+class PvsTable
+{
+private:
+    int rows = 0, cols = 0;
+    int floorCount = 0, stride = 0;  // stride: words per bit row
+    std::vector<int> floorIndex;     // cell id -> floor index, -1 for walls
+    std::vector<int> floorCell;      // floor index -> cell id
+    std::vector<uint32_t> bits;      // floorCount rows of stride words
+    std::thread builder;
+    std::atomic<bool> ready{false}, cancel{false};
+    void Fill(std::vector<uint8_t> walls);
+public:
+    ~PvsTable();
+    void Build(const Map& map);
+    void Wait(); // blocks until the background build is done
+    bool IsReady() const;
+    int GetFloorIndex(float x, float y) const; // -1 for walls, outside the map and before the table is ready
+    bool CanSee(int fromFloor, int toFloor) const;
+    bool CanSee(float ax, float ay, float bx, float by) const; // out-of-map points are never rejected
+    int CountVisible(int fromFloor) const; // within the window
+    int GetFloorCount() const;
+};
@@ -14,43 +14,92 @@
 #include "Player.h"
 #include "Sprites.h"
 #include "Interface.h"
+#include "ThreadPool.h"
+#include "TextureAtlas.h"
+#include "Profiler.h"
+#include "WorldSnapshot.h"
+#include "TextRenderer.h"
 #define INF 10000000.0f
+#define FOV_ANGLE (PI / 3.0f)
+#define SPRITE_NEAR 0.6f
+#define DEPTH_KEY_SCALE 256.0f // depth key steps per map unit
+#define MINIMAP_MAX_W 320      // on-screen minimap window, larger maps scroll with the player
+#define MINIMAP_MAX_H 240
+#define FONT_PATH "res/font/arial.ttf"
 namespace fs = std::filesystem;
 class Renderer
 {
 public:
     bool OpenWindow(const char* title, int w, int h, bool fullscreen, bool resizable);
     void ImportMap(Map& mpp);
-    void ImportPlayer(Player& player);
-    void ImportSprites(std::vector<Sprites>& spt);
     void ImportInterface(Interface& temp);
     void CleanUp();
+    void SetSnapshot(const WorldSnapshot& snapshot); // world state the next passes draw
     void Clear();
     void RenderEnd(int Score, int maxScore);
-    void Render2DPlayer(float scale);
-    void Render2DMap(float scale);
-    void Render2DSprites(float scale);
+    void RenderHud(float fps, int round, int score);
+    void RenderLoading(float progress);
+    void Render2DMap(float scale);     // baked wall layer, the part around the player
+    void Render2DMarkers(float scale); // player and sprites, one geometry batch
     void RenderBackGround();
     void RenderSprites();
+    void RenderProfilerOverlay();
     void RayCasting();
     void Display();
-    void LoadTextures(const std::string& folder);
+    void SetRenderScale(float scale); // internal resolution as a fraction of the window, per axis
+    float GetRenderScale() const;
+    bool AddTexture(SDL_Surface* pixels, const std::string& path); // takes the decoded surface, on the render thread
+    int AddFolder(const std::string& folder, const std::vector<SDL_Surface*>& sheets, const std::vector<int>& frameCounts); // -1 if a sheet is missing
+    int FindTextures(const std::string& folder) const;
     SDL_Texture* GetTextureByIndex(int index);
     int GetTexSize();
     void ClearTex();
-    void LoadBG();
-    void SortSprites(std::vector<Sprites>* list);
+    void SetSheetFrames(int texBase, const std::vector<int>& frameCounts);
 private:
-    int width, height;
+    int width, height;   // window
+    int viewW, viewH;    // internal render target for walls and sprites, upscaled on present
     SDL_Window* window;
     SDL_Renderer* renderer;
-    Player* mainPlayer;
     Map* mainMap;
-    std::vector<Sprites>* SpritesList;
+    const WorldSnapshot* view = nullptr;
     std::vector<float> depthBuffer;
+    std::vector<float> cameraX; // per-column offset along the camera plane, -1 (left) .. 1 (right)
     std::vector<SDL_Texture*> textures;
-    float RayVert(float angle, float px, float py, float& xvert, float& yvert);
-    float RayHor(float angle, float px, float py, float& xhor, float& yhor);
-    void DrawColByColor(int i, int height, float distanceCorrected);
-    void DrawColByTex(int i, int height, float distanceCorrected, float xwall, float ywall, bool walltype);
+    TextureAtlas atlas;                  // decoded texels, same indices as textures
+
+    std::map<std::string, int> folderCache; // folder -> first texture; loaded once, resident until ClearTex
+    // One visible sprite of the current frame; the simulation's sprite array is never reordered
+    struct DrawItem
+    {
+        uint32_t key;  // quantized depth, far sprites get small keys
+        int index;     // into the snapshot's sprites
+        int texIndex;
+        int frame;
+        float depth;   // camera-space distance along the view direction
+        int screenX;
+        int spriteW, spriteH; // on-screen size in pixels
+    };
+    std::vector<DrawItem> drawList;
+    std::vector<DrawItem> drawScratch;
+    std::vector<Uint32> frameBuffer;     // software wall and sprite layer, uploaded once per frame
+    SDL_Texture* frameTex;
+    SDL_Texture* minimapTex = nullptr;   // static wall layer, rebuilt when the map or the scale changes
+    int minimapVersion = -1;
+    int minimapTile = 0, minimapTexTile = 0; // pixels per tile on screen / in the texture
+    SDL_Rect minimapView = {0, 0, 0, 0}; // visible window in on-screen map pixels
+    std::vector<SDL_Vertex> markerVerts;
+    TextRenderer hudText;   // 32pt: HUD and end screen
+    TextRenderer labelText; // 12pt: profiler labels
+    int hudFps = 0;
+    Uint32 hudFpsTime = 0;  // when hudFps was last refreshed, the counter is redrawn 4 times a second
+    std::vector<int> markerIdx;
+    ThreadPool workers;
+    void UploadFrame();
+    bool BakeMinimap(int tile);
+    void AddMarkerQuad(float x0, float y0, float x1, float y1, float halfW, SDL_Color c);
+    void BuildDrawList();
+    void SortDrawList();
+    void DrawSpriteColumns(const DrawItem& d, int pitchOffset, int begin, int end);
+    void DrawColByColor(int i, float distanceCorrected);
+    void DrawColByTex(int i, const RayHit& hit);
 };
@@ -0,0 +1,25 @@
+#pragma once
+#define RES_SCALE_MIN 0.4f   // of the window size, per axis
+#define RES_SCALE_MAX 1.0f
+#define RES_SCALE_STEP 0.05f // largest step up per adjustment
+#define RES_HEADROOM 0.85f   // aim for this fraction of the budget
+
+// Picks the internal render scale from the measured CPU frame time (work only, the frame
+// limiter's sleep excluded). Render cost grows with pixel count, so a slow frame shrinks the
+// scale by sqrt(budget / time) at once; spare time grows it back one small step at a time.
+class ResolutionController
+{
+private:
+    bool enabled = false;
+    float budgetMs = 1000.0f / 60.0f;
+    float scale = RES_SCALE_MAX;
+    float avgMs = 0.0f;  // exponential average of the frame work time
+    int cooldown = 0;    // frames to wait before the next adjustment
+public:
+    void Enable(float frameBudgetMs);
+    void Disable(float fixedScale = RES_SCALE_MAX);
+    bool IsEnabled() const;
+    float Update(float workMs); // returns the scale for the next frame
+    float GetScale() const;
+    float GetAverageMs() const;
+};
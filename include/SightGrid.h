@@ -0,0 +1,24 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "Map.h"
+
+// Bit-packed copy of the map's wall flags (one bit per tile, rows padded to 32-bit words)
+// and a batched line-of-sight test against it. Lanes walk the tiles between each viewer and
+// the target with a grid DDA; AVX2 runs 8 lanes, SSE2 4, anything else falls back to scalar.
+class SightGrid
+{
+private:
+    int rows = 0, cols = 0, stride = 0; // stride: words per row
+    std::vector<uint32_t> bits;
+    std::vector<float> sinBuf, cosBuf;  // viewer facing, filled once per batch
+    bool CheckOne(float x, float y, float c, float s, float tx, float ty, float cosHalfFov, float maxDepth) const;
+public:
+    void Init(const Map& map);
+    bool IsWall(int row, int col) const; // out of bounds counts as wall
+
+    // out[i] = 1 when (tx, ty) is within maxDepth of viewer i, inside its fov and no wall tile
+    // lies on the segment between them, 0 otherwise
+    void CheckSight(const float* xs, const float* ys, const float* angles, int count,
+                    float tx, float ty, float fov, float maxDepth, uint8_t* out);
+};
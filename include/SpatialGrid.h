@@ -0,0 +1,27 @@
+#pragma once
+#include <vector>
+
+// Uniform grid with one bucket per map tile. Stores plain indices into the caller's array;
+// buckets are laid out back to back by a counting sort, so bucket c is items[cellStart[c] .. cellStart[c + 1]).
+class SpatialGrid
+{
+private:
+    int rows = 0, cols = 0;
+    std::vector<int> cellStart; // rows * cols + 1 offsets into items
+    std::vector<int> items;
+    std::vector<int> itemCell;  // bucket of every inserted index, -1 if not inserted
+    std::vector<int> cursor;    // scatter position per bucket, reused across rebuilds
+    int CellOf(float x, float y) const;
+public:
+    void Init(int rows, int cols);
+
+    // Rebuild: Begin(count), Insert() any subset of [0, count), then End()
+    void Begin(int count);
+    void Insert(int index, float x, float y);
+    void End();
+
+    // Append candidates whose bucket touches the area; callers do the exact test on live positions
+    void QueryAABB(float minX, float minY, float maxX, float maxY, std::vector<int>& out) const;
+    void QueryRadius(float x, float y, float radius, std::vector<int>& out) const;
+    int GetCellOf(int index) const;
+};
@@ -1,64 +1,52 @@
 #pragma once
 #include <cmath>
 #include <vector>
-#include <SDL.h>
-#include <SDL_image.h>
-#include <list>
-#include <string>
+#include <cstdint>
+#include "FastMath.h"
+#include "EnemyTypes.h"
 #define PI 3.14159265f
-#define St2Delay 14
-#define St3Delay 8
-#define St4Delay 15
-#define St5Delay 9
+#define SPRITE_RIGID    1
+#define SPRITE_VISIBLE  2
+#define SPRITE_DEAD     4
+#define SPRITE_ANI_DONE 8
 
+// Every enemy of the round, one array per field. Tick passes stream over the arrays by index; sprites
+// are only ever added or cleared with the wave, so an index stays valid until Clear.
+// Per-kind constants (speed, damage, sheets) stay in ENEMY_TYPES.
 class Sprites
 {
-private:
-    float posx, posy;
-    float oldx, oldy;
-    float angle;
-    float speed;
-    float rot_speed;
-    bool rigid;
-    bool visible;
-    int DEFAULTSTATE;
-    int texid;
-    int AniFrame_counter;
-    int AniFrame_delay;
-    bool AniDone;
-    int state;
-    bool dead;
 public:
-    Sprites(float x, float y, float a, float s, float rs, bool rg, bool vs, int defaultState, int index, std::string n, float hp, float dm, float rag);
-    virtual ~Sprites() {}
-    std::vector<std::pair<int, int>> path;
-    int GetDirIndex(float playerX, float playerY, float playerAngle, int numDirections) const;
-    float GetOldX() const;
-    float GetOldY() const;
-    float GetX() const;
-    float GetY() const;
-    float GetA() const;
-    float GetS() const;
-    int GetR() const;
-    int GetDefaultState();
-    int GetState() const;
-    int GetTexID() const;
-    int GetAniCnt() const;
-    bool CheckRigid() const;
-    bool CheckVisible() const;
-    void SetState(int s);
-    void UpdateAnimation();
-    bool CheckAni();
-    void ChangePos(std::pair<float, float> pos);
-    void Rotate(float deltaAngle);
-    void SetTexID(int id);
-    std::list<Sprites*>::iterator ListIt;
-    std::string name;
-    float HP;
-    void UpdateSprite();
-    void UpdateAI();
-    void TakeDamage(float amount);
-    bool IsDead() const;
-    float damage;
-    float range;
+    // Hot, all Size() long
+    std::vector<float> posX, posY;
+    std::vector<float> prevX, prevY;   // position at the start of the current simulation tick
+    std::vector<float> prevAngle, angle;
+    std::vector<float> velX, velY;     // units per second, written by the AI and integrated by Physics
+    std::vector<float> hp;
+    std::vector<uint8_t> state;
+    std::vector<uint8_t> aniCnt, aniDelay;
+    std::vector<uint8_t> flags;        // SPRITE_* bits
+    std::vector<uint8_t> type;         // EnemyType
+
+    int Add(int enemyType, float x, float y, float a); // index of the new sprite
+    void Clear();
+    int Size() const;
+
+    bool IsDead(int i) const;
+    bool IsRigid(int i) const;
+    bool IsVisible(int i) const;
+    bool CheckAni(int i) const;
+    int CountDead() const;
+    int GetDefaultState(int i) const;
+    const EnemyTypeInfo& GetInfo(int i) const;
+
+    void SetState(int i, int s);
+    void SetVelocity(int i, float vx, float vy);
+    void Rotate(int i, float deltaAngle);
+    void TakeDamage(int i, float amount);
+    void UpdateAnimation(int i);
+    void UpdateStates();
+    void UpdateAnimations();
+    void SavePoses();
+
+    static int DirIndex(float spriteX, float spriteY, float spriteAngle, float viewX, float viewY, int numDirections);
 };
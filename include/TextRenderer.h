@@ -0,0 +1,48 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#define TEXT_FIRST_GLYPH 32  // printable ASCII only, anything else is drawn as '?'
+#define TEXT_LAST_GLYPH 126
+#define TEXT_ATLAS_WIDTH 512
+#define TEXT_CACHE_MAX 256   // laid-out strings kept before the cache is dropped
+
+enum TextAlign {TEXT_LEFT, TEXT_CENTER, TEXT_RIGHT};
+
+// One font size rasterized once into a glyph atlas. A string is laid out into quads the first
+// time it is drawn and cached by content; Draw only copies the cached quads into the frame's
+// batch, and Flush submits the whole batch as one SDL_RenderGeometry call.
+class TextRenderer
+{
+private:
+    struct Glyph
+    {
+        SDL_Rect src;  // in the atlas
+        int advance;
+    };
+    struct Layout
+    {
+        std::vector<SDL_FPoint> pos, uv; // 4 corners per glyph, relative to the top-left
+        int width;
+    };
+    SDL_Renderer* renderer = nullptr;
+    TTF_Font* font = nullptr;     // kept open for kerning while laying out new strings
+    SDL_Texture* atlas = nullptr;
+    int atlasW = 0, atlasH = 0;
+    int lineHeight = 0;
+    Glyph glyphs[TEXT_LAST_GLYPH - TEXT_FIRST_GLYPH + 1];
+    std::unordered_map<std::string, Layout> cache;
+    std::vector<SDL_Vertex> verts;
+    std::vector<int> indices;
+    const Layout& GetLayout(const std::string& text);
+public:
+    bool Init(SDL_Renderer* rd, const std::string& fontPath, int ptSize);
+    void CleanUp();
+    bool IsReady() const;
+    int Measure(const std::string& text);
+    int GetLineHeight() const;
+    void Draw(const std::string& text, int x, int y, SDL_Color color, TextAlign align = TEXT_LEFT);
+    void Flush(); // submit everything drawn since the last flush
+};
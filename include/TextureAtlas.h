@@ -0,0 +1,33 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <vector>
+
+// One decoded image inside the atlas. Texels are stored transposed (column-major),
+// so a vertical strip of the image is a contiguous run of h texels.
+struct AtlasEntry
+{
+    size_t offset;
+    int w, h;
+    std::vector<SDL_Rect> frames; // equal-width frames of a sprite sheet, whole image by default
+};
+
+class TextureAtlas
+{
+private:
+    std::vector<Uint32> texels;
+    std::vector<AtlasEntry> entries;
+public:
+    int Add(SDL_Surface* argb);
+    void SetFrames(int id, int frameCount);
+    void Clear();
+    int Size() const;
+    const AtlasEntry& Get(int id) const {return entries[id];}
+    const SDL_Rect& GetFrame(int id, int frame) const;
+
+    // Column x of entry id, h texels top to bottom; caller guarantees 0 <= x < w
+    const Uint32* Column(int id, int x) const
+    {
+        const AtlasEntry& e = entries[id];
+        return &texels[e.offset + (size_t)x * e.h];
+    }
+};
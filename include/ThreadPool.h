@@ -0,0 +1,33 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+// Fixed set of worker threads that split a [0, count) range into chunks.
+// ParallelFor blocks until every worker has drained the range; the calling thread works too.
+class ThreadPool
+{
+private:
+    std::vector<std::thread> workers;
+    std::mutex mtx;
+    std::condition_variable wakeCv;
+    std::condition_variable doneCv;
+    const std::function<void(int, int)>* job = nullptr;
+    int jobCount = 0;
+    int chunkSize = 1;
+    std::atomic<int> nextChunk{0};
+    size_t finishedWorkers = 0;
+    unsigned int generation = 0;
+    bool stopping = false;
+
+    void WorkerLoop();
+    void RunChunks();
+public:
+    bool Init(int threadCount = 0, bool quiet = false); // 0: one per hardware thread
+    void ParallelFor(int count, const std::function<void(int begin, int end)>& fn);
+    int GetThreadCount() const;
+    void CleanUp();
+};
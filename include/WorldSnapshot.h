@@ -0,0 +1,56 @@
+#pragma once
+#include <vector>
+#include <atomic>
+#include "Interface.h"
+#include "FastMath.h"
+
+// Everything the render passes read about one sprite
+struct SpriteView
+{
+    float prevX, prevY, prevAngle; // pose at the start of the last tick
+    float x, y;
+    float angle;
+    int texIndex;       // texture of the current state, -1 if the sheet is missing
+    int state;
+    int aniCnt;
+    bool visible;
+    bool dead;
+};
+
+// Immutable copy of the world after a batch of simulation ticks.
+// The simulation thread fills one, the render thread draws another.
+struct WorldSnapshot
+{
+    float prevPlayerX = 0, prevPlayerY = 0;
+    float playerX = 0, playerY = 0;
+    float prevPlayerAngle = 0, playerAngle = 0, playerPitch = 0;
+    float playerHp = 0;
+    int round = 0, score = 0;
+    float alpha = 1.0f; // blend between the prev and current poses
+    WeaponView weapon;
+    std::vector<SpriteView> sprites;
+
+    float LerpPlayerX() const {return prevPlayerX + (playerX - prevPlayerX) * alpha;}
+    float LerpPlayerY() const {return prevPlayerY + (playerY - prevPlayerY) * alpha;}
+    float LerpX(const SpriteView& s) const {return s.prevX + (s.x - s.prevX) * alpha;}
+    float LerpY(const SpriteView& s) const {return s.prevY + (s.y - s.prevY) * alpha;}
+    // Angles take the short way round, so a turn across 0 / 2pi does not spin backwards
+    float LerpPlayerAngle() const {return prevPlayerAngle + FastMath::WrapAngle(playerAngle - prevPlayerAngle) * alpha;}
+    float LerpAngle(const SpriteView& s) const {return s.prevAngle + FastMath::WrapAngle(s.angle - s.prevAngle) * alpha;}
+};
+
+// Lock-free triple buffer with one writer and one reader. The writer always owns a slot,
+// the reader always owns a slot, and the third one is handed over with a single atomic exchange.
+class SnapshotBuffer
+{
+private:
+    static constexpr int FRESH = 4; // set on the shared index when the writer published since the last Acquire
+    WorldSnapshot slots[3];
+    std::atomic<int> shared{1};
+    int back = 0;  // writer's slot
+    int front = 2; // reader's slot
+public:
+    WorldSnapshot& WriteSlot() {return slots[back];}
+    void Publish();
+    const WorldSnapshot& Acquire(); // latest published snapshot, or the previous one if nothing new
+};
@@ -0,0 +1,189 @@
+#include "AssetLoader.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <filesystem>
+namespace fs = std::filesystem;
+
+static float MsSince(Uint64 start)
+{
+    return (float)(SDL_GetPerformanceCounter() - start) * 1000.0f / (float)SDL_GetPerformanceFrequency();
+}
+
+SDL_Surface* AssetLoader::DecodeImage(const std::string& path)
+{
+    SDL_Surface* loaded = IMG_Load(path.c_str());
+    if (!loaded) {
+        std::cerr << "Failed to load " << path << ": "
+                  << IMG_GetError() << "\n";
+        return nullptr;
+    }
+    SDL_Surface* pixels = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_ARGB8888, 0);
+    SDL_FreeSurface(loaded);
+    if (!pixels) {
+        std::cerr << "Failed to convert " << path << ": "
+                  << SDL_GetError() << "\n";
+        return nullptr;
+    }
+    return pixels;
+}
+
+SDL_Surface* AssetLoader::DecodeSheet(const std::string& path)
+{
+    if (!fs::is_directory(path)) return DecodeImage(path);
+
+    std::vector<SDL_Surface*> frames;
+    int cellW = 0, cellH = 0;
+    for (const auto& file : ListFiles(path))
+    {
+        SDL_Surface* frame = DecodeImage(file);
+        if (!frame) continue;
+        cellW = std::max(cellW, frame->w);
+        cellH = std::max(cellH, frame->h);
+        frames.push_back(frame);
+    }
+    if (frames.empty()) {
+        std::cerr << "No frames in " << path << "\n";
+        return nullptr;
+    }
+
+    // Equal-width cells so the atlas can split the sheet evenly; frames are centered and stand on the bottom edge
+    SDL_Surface* sheet = SDL_CreateRGBSurfaceWithFormat(0, cellW * (int)frames.size(), cellH, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (sheet) SDL_FillRect(sheet, NULL, 0);
+    for (size_t i = 0; i < frames.size(); i++)
+    {
+        if (sheet)
+        {
+            SDL_SetSurfaceBlendMode(frames[i], SDL_BLENDMODE_NONE);
+            SDL_Rect dst = {(int)i * cellW + (cellW - frames[i]->w) / 2, cellH - frames[i]->h, frames[i]->w, frames[i]->h};
+            SDL_BlitSurface(frames[i], NULL, sheet, &dst);
+        }
+        SDL_FreeSurface(frames[i]);
+    }
+    if (!sheet) std::cerr << "Failed to create sheet for " << path << ": " << SDL_GetError() << "\n";
+    return sheet;
+}
+
+std::vector<std::string> AssetLoader::ListFiles(const std::string& folder, const std::vector<std::string>& exts)
+{
+    std::vector<std::string> files;
+    if (!fs::exists(folder) || !fs::is_directory(folder)) {
+        std::cerr << "Cannot open folder: " << folder << "\n";
+        return files;
+    }
+    for (const auto& entry : fs::directory_iterator(folder))
+    {
+        if (!entry.is_regular_file()) continue;
+        std::string ext = entry.path().extension().string();
+        if (!exts.empty() && std::find(exts.begin(), exts.end(), ext) == exts.end()) continue;
+        files.push_back(entry.path().string());
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+void AssetLoader::Decode(Asset& a)
+{
+    Uint64 start = SDL_GetPerformanceCounter();
+    switch (a.kind)
+    {
+        case ASSET_IMAGE: a.pixels = DecodeImage(a.path); break;
+        case ASSET_SHEET: a.pixels = DecodeSheet(a.path); break;
+        case ASSET_SOUND:
+            a.chunk = Mix_LoadWAV(a.path.c_str());
+            if (!a.chunk) std::cerr << "Failed to load sound: " << a.path << " | Error: " << Mix_GetError() << std::endl;
+            break;
+        case ASSET_MUSIC:
+            a.music = Mix_LoadMUS(a.path.c_str());
+            if (!a.music) std::cerr << "Failed to load music: " << a.path << " | Error: " << Mix_GetError() << std::endl;
+            break;
+    }
+    a.decodeMs = MsSince(start);
+}
+
+void AssetLoader::Queue(AssetKind kind, const std::vector<std::string>& paths, std::function<void(std::vector<Asset>&)> commit)
+{
+    auto g = std::make_unique<Group>();
+    for (const auto& p : paths)
+    {
+        Asset a;
+        a.kind = kind;
+        a.path = p;
+        g->assets.push_back(a);
+    }
+    g->remaining = (int)paths.size();
+    g->commit = std::move(commit);
+    groups.push_back(std::move(g));
+}
+
+void AssetLoader::Start()
+{
+    startCounter = SDL_GetPerformanceCounter();
+    work.clear();
+    for (auto& g : groups)
+        for (int i = 0; i < (int)g->assets.size(); i++) work.push_back({g.get(), i});
+    decoded = 0;
+    if (work.empty()) return;
+
+    // The runner is the pool's calling thread, so this thread stays free to draw and commit
+    pool.Init();
+    runner = std::thread([this] {
+        pool.ParallelFor((int)work.size(), [this](int begin, int end) {
+            for (int i = begin; i < end; i++)
+            {
+                Decode(work[i].first->assets[work[i].second]);
+                work[i].first->remaining--;
+                decoded++;
+            }
+        });
+    });
+}
+
+bool AssetLoader::CommitReady()
+{
+    while (nextGroup < groups.size() && groups[nextGroup]->remaining == 0)
+    {
+        Group& g = *groups[nextGroup];
+        Uint64 start = SDL_GetPerformanceCounter();
+        if (g.commit) g.commit(g.assets);
+        g.commitMs = MsSince(start);
+        nextGroup++;
+    }
+    return nextGroup == groups.size();
+}
+
+float AssetLoader::GetProgress() const
+{
+    return work.empty() ? 1.0f : (float)decoded / (float)work.size();
+}
+
+void AssetLoader::Finish()
+{
+    if (runner.joinable()) runner.join();
+    while (!CommitReady()) {}
+    int threads = pool.GetThreadCount();
+    pool.CleanUp();
+    wallMs = MsSince(startCounter);
+
+    // Slowest decodes first; the sum against the wall time shows what the pool saved
+    std::vector<const Asset*> all;
+    float decodeSum = 0.0f, commitSum = 0.0f;
+    for (const auto& g : groups)
+    {
+        commitSum += g->commitMs;
+        for (const auto& a : g->assets) all.push_back(&a), decodeSum += a.decodeMs;
+    }
+    std::sort(all.begin(), all.end(), [](const Asset* a, const Asset* b) {return a->decodeMs > b->decodeMs;});
+    std::ios::fmtflags flags = std::cout.flags();
+    std::streamsize precision = std::cout.precision();
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Loaded " << all.size() << " assets in " << wallMs << " ms (decode " << decodeSum
+              << " ms on " << threads << " threads, commit " << commitSum << " ms)" << std::endl;
+    for (const Asset* a : all) std::cout << "  " << std::setw(8) << a->decodeMs << " ms  " << a->path << "\n";
+    std::cout.flags(flags);
+    std::cout.precision(precision);
+
+    groups.clear();
+    work.clear();
+    nextGroup = 0;
+}
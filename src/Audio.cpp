@@ -1,6 +1,7 @@
 #include "Audio.h"
+#include <algorithm>
 
-bool Audio::Init()
+bool Audio::Init(int voiceCount)
 {
     if (Mix_Init(MIX_INIT_MP3 | MIX_INIT_OGG) < 0) {
         std::cerr << "Failed to initialize SDL_mixer: " << Mix_GetError() << std::endl;
@@ -12,6 +13,11 @@ bool Audio::Init()
         return false;
     }
 
+    // Channel 0 is kept out of the pool for PlayExclusiveSound
+    Mix_AllocateChannels(FIRST_VOICE + voiceCount);
+    Mix_ReserveChannels(FIRST_VOICE);
+    voices.assign(voiceCount, Voice());
+
     std::cout << "AudioManager Initialized Successfully!" << std::endl;
     return true;
 }
@@ -23,17 +29,82 @@ void Audio::PlayMusic(const std::string& name, int loops)
     }
 }
 
-void Audio::PlaySound(const std::string& name, int loops)
+SoundHandle Audio::GetSound(const std::string& name) const
+{
+    auto it = soundNames.find(name);
+    return it == soundNames.end() ? INVALID_SOUND : it->second;
+}
+
+void Audio::SetSoundParams(SoundHandle sound, int priority, int maxInstances)
+{
+    if (sound < 0 || sound >= (int)sounds.size()) return;
+    sounds[sound].priority = priority;
+    sounds[sound].maxInstances = std::max(1, maxInstances);
+}
+
+void Audio::PlaySound(SoundHandle sound, int loops)
 {
-    if (soundEffects.find(name) != soundEffects.end()) {
-        Mix_PlayChannel(-1, soundEffects[name], loops);
+    if (sound < 0 || sound >= (int)sounds.size()) return;
+    if (sounds[sound].queuedTick == tick) return; // already queued this tick
+    sounds[sound].queuedTick = tick;
+    pending.push_back({sound, loops});
+}
+
+int Audio::PickVoice(SoundHandle sound, int priority)
+{
+    int freeVoice = -1, oldestSame = -1, victim = -1, instances = 0;
+    for (int i = 0; i < (int)voices.size(); i++)
+    {
+        Voice& v = voices[i];
+        if (v.sound != INVALID_SOUND && !Mix_Playing(FIRST_VOICE + i)) v.sound = INVALID_SOUND;
+        if (v.sound == INVALID_SOUND)
+        {
+            if (freeVoice < 0) freeVoice = i;
+            continue;
+        }
+        if (v.sound == sound)
+        {
+            instances++;
+            if (oldestSame < 0 || v.started < voices[oldestSame].started) oldestSame = i;
+        }
+        if (victim < 0 || v.priority < voices[victim].priority ||
+            (v.priority == voices[victim].priority && v.started < voices[victim].started)) victim = i;
+    }
+    if (instances >= sounds[sound].maxInstances) return oldestSame;
+    if (freeVoice >= 0) return freeVoice;
+    if (victim >= 0 && voices[victim].priority <= priority) return victim;
+    return -1;
+}
+
+void Audio::Flush()
+{
+    tick++;
+    if (pending.empty()) return;
+    // Highest priority first so a crowded tick drops the least important sounds
+    std::stable_sort(pending.begin(), pending.end(), [&](const Request& a, const Request& b) {
+        return sounds[a.sound].priority > sounds[b.sound].priority;
+    });
+    for (const Request& r : pending)
+    {
+        const Sound& snd = sounds[r.sound];
+        int v = PickVoice(r.sound, snd.priority);
+        if (v < 0) continue;
+        if (Mix_PlayChannel(FIRST_VOICE + v, snd.chunk, r.loops) < 0) {
+            voices[v].sound = INVALID_SOUND;
+            continue;
+        }
+        voices[v] = {r.sound, snd.priority, ++startCount};
     }
+    pending.clear();
 }
 
 void Audio::CleanUp()
 {
-    for (auto const& pair : soundEffects) Mix_FreeChunk(pair.second);
-    soundEffects.clear();
+    Mix_HaltChannel(-1);
+    for (auto const& snd : sounds) Mix_FreeChunk(snd.chunk);
+    sounds.clear();
+    soundNames.clear();
+    pending.clear();
 
     for (auto const& pair : musicTracks) Mix_FreeMusic(pair.second);
     musicTracks.clear();
@@ -57,77 +128,63 @@ std::string Audio::GetFilenameWithoutExtension(const std::string& path)
 
 void Audio::LoadMusic(const std::string& folderPath)
 {
-    if (!fs::exists(folderPath) || !fs::is_directory(folderPath)) {
-        std::cerr << "Cannot open music folder: " << folderPath << std::endl;
-        return;
-    }
-
     std::cout << "Loading music from " << folderPath << "..." << std::endl;
-
-    for (const auto& entry : fs::directory_iterator(folderPath)) {
-        if (!entry.is_regular_file()) continue;
-
-        auto path = entry.path();
-        auto ext  = path.extension().string();
-
-        if (ext != ".mp3" && ext != ".ogg" && ext != ".wav")
-            continue;
-
-        std::string nameKey = path.stem().string();
-
-        Mix_Music* music = Mix_LoadMUS(path.string().c_str());
+    for (const auto& path : AssetLoader::ListFiles(folderPath, {".mp3", ".ogg", ".wav"}))
+    {
+        Mix_Music* music = Mix_LoadMUS(path.c_str());
         if (!music) {
             std::cerr << "Failed to load music: "
                       << path << " | Error: "
                       << Mix_GetError() << std::endl;
-        } else {
-            musicTracks[nameKey] = music;
-            std::cout << "  - Loaded music: " << nameKey << std::endl;
+            continue;
         }
+        AddMusic(fs::path(path).stem().string(), music);
     }
 }
 
-
-
 void Audio::LoadSound(const std::string& folderPath)
 {
-    if (!fs::exists(folderPath) || !fs::is_directory(folderPath)) {
-        std::cerr << "Cannot open sound folder: " << folderPath << std::endl;
-        return;
-    }
-
     std::cout << "Loading sounds from " << folderPath << "..." << std::endl;
-
-    for (const auto& entry : fs::directory_iterator(folderPath)) {
-        if (!entry.is_regular_file()) continue;
-
-        auto path = entry.path();
-        auto ext  = path.extension().string();
-
-        if (ext != ".wav")
-            continue;
-
-        std::string nameKey = path.stem().string();
-
-        Mix_Chunk* sound = Mix_LoadWAV(path.string().c_str());
+    for (const auto& path : AssetLoader::ListFiles(folderPath, {".wav"}))
+    {
+        Mix_Chunk* sound = Mix_LoadWAV(path.c_str());
         if (!sound) {
             std::cerr << "Failed to load sound: "
                       << path << " | Error: "
                       << Mix_GetError() << std::endl;
-        } else {
-            soundEffects[nameKey] = sound;
-            std::cout << "  - Loaded sound: " << nameKey << std::endl;
+            continue;
         }
+        AddSound(fs::path(path).stem().string(), sound);
     }
 }
 
+void Audio::AddMusic(const std::string& name, Mix_Music* music)
+{
+    if (!music) return;
+    auto it = musicTracks.find(name);
+    if (it != musicTracks.end()) Mix_FreeMusic(it->second);
+    musicTracks[name] = music;
+    std::cout << "  - Loaded music: " << name << std::endl;
+}
 
-void Audio::PlayExclusiveSound(const std::string& name, int loops)
+void Audio::AddSound(const std::string& name, Mix_Chunk* sound)
 {
-    if (soundEffects.find(name) != soundEffects.end())
-    {
-        Mix_HaltChannel(EXCLUSIVE_CHANNEL);
-        Mix_PlayChannel(EXCLUSIVE_CHANNEL, soundEffects[name], loops);
+    if (!sound) return;
+    auto it = soundNames.find(name);
+    if (it != soundNames.end()) {
+        Mix_FreeChunk(sounds[it->second].chunk);
+        sounds[it->second].chunk = sound;
+    } else {
+        soundNames[name] = (SoundHandle)sounds.size();
+        sounds.push_back({sound, 0, AUDIO_MAX_INSTANCES, 0});
     }
+    std::cout << "  - Loaded sound: " << name << std::endl;
 }
 
+
+void Audio::PlayExclusiveSound(SoundHandle sound, int loops)
+{
+    if (sound < 0 || sound >= (int)sounds.size()) return;
+    Mix_HaltChannel(EXCLUSIVE_CHANNEL);
+    Mix_PlayChannel(EXCLUSIVE_CHANNEL, sounds[sound].chunk, loops);
+}
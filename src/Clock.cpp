@@ -4,37 +4,57 @@ Clock::Clock()
 {
     lastCounter = SDL_GetPerformanceCounter();
     frequency = SDL_GetPerformanceFrequency();
-    deltaTime = 0.0;
+    frameTime = 0.0;
     fps = 0.0;
 }
 
 void Clock::tick(int targetFPS)
 {
     Uint64 currentCounter = SDL_GetPerformanceCounter();
-    deltaTime = (float)(currentCounter - lastCounter) / (float)frequency;
-    lastCounter = currentCounter;
-
-
-    if (deltaTime > 0)
-        fps = 1.0 / deltaTime;
+    workTime = (float)(currentCounter - lastCounter) / (float)frequency;
 
-
-    if (targetFPS > 0)
+    if (targetFPS > 0 && fixedDelta <= 0)
     {
-        float frameDuration = 1.0 / (float)targetFPS;
-        if (deltaTime < frameDuration)
+        // SDL_Delay only has millisecond granularity: sleep most of the gap, then spin the rest
+        Uint64 frameEnd = lastCounter + frequency / targetFPS;
+        while (currentCounter < frameEnd)
         {
-            Uint32 delayMs = static_cast<Uint32>((frameDuration - deltaTime) * 1000.0);
-            if (delayMs > 0) SDL_Delay(delayMs);
-
-            Uint64 newCounter = SDL_GetPerformanceCounter();
-            deltaTime = (float)(newCounter - currentCounter) / (float)frequency;
-            deltaTime = std::max(deltaTime, 0.025f);
-            lastCounter = newCounter;
+            Uint32 remainingMs = (Uint32)((frameEnd - currentCounter) * 1000 / frequency);
+            if (remainingMs > 2) SDL_Delay(remainingMs - 2);
+            currentCounter = SDL_GetPerformanceCounter();
         }
     }
+
+    frameTime = fixedDelta > 0 ? fixedDelta : (float)(currentCounter - lastCounter) / (float)frequency;
+    lastCounter = currentCounter;
+
+    if (frameTime > 0)
+        fps = 1.0 / frameTime;
+
+    accumulator += std::min(frameTime, MAX_FRAME_TIME);
 }
 
-float Clock::getDeltaTime() const {return deltaTime;}
+float Clock::getDeltaTime() const {return tickDelta;}
+
+float Clock::getFrameTime() const {return frameTime;}
+
+float Clock::getWorkTime() const {return workTime;}
 
 float Clock::getFPS() const {return fps;}
+
+void Clock::setTickRate(int hz)
+{
+    if (hz <= 0) return;
+    tickDelta = 1.0f / (float)hz;
+}
+
+bool Clock::stepTick()
+{
+    if (accumulator < tickDelta) return false;
+    accumulator -= tickDelta;
+    return true;
+}
+
+float Clock::getAlpha() const {return std::min(accumulator / tickDelta, 1.0f);}
+
+void Clock::setFixedDelta(float dt) {fixedDelta = dt;}
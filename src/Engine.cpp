@@ -2,6 +2,8 @@
 
 // ===== INITIALIZATION =====
 
+Engine::Engine() {std::fill(std::begin(enemyTexBase), std::end(enemyTexBase), -1);}
+
 bool Engine::InitRenderer(const char* title, int w, int h, bool fullscreen, bool resizable) {return renderer.OpenWindow(title, w, h, fullscreen, resizable);}
 
 bool Engine::InitUI() {return ui.Init();}
@@ -10,6 +12,8 @@ bool Engine::InitAudio() {return audioManager.Init();}
 
 bool Engine::InitMap(const std::vector<std::vector<int>>& miniMap) {return worldMap.Init(miniMap);}
 
+void Engine::WaitForMap() {worldMap.WaitPvs();}
+
 bool Engine::InitPlayer(std::pair<float, float> pos, float angle, float speed, float hp) {return player.Init(pos, angle, speed, hp);}
 
 void Engine::SetupConnections()
@@ -17,52 +21,94 @@ void Engine::SetupConnections()
     // Connect modules that depend on each other
     physicsManager.ImportEntity(worldMap, player, clock, sprites);
     renderer.ImportMap(worldMap);
-    renderer.ImportPlayer(player);
-    renderer.ImportSprites(sprites);
     renderer.ImportInterface(ui);
 }
 
 // ===== RENDERING =====
 
-void Engine::ClearScreen() {renderer.Clear();}
+void Engine::BeginRenderFrame()
+{
+    renderView = &snapshots.Acquire();
+    renderer.SetSnapshot(*renderView);
+    if (resolution.IsEnabled()) renderer.SetRenderScale(resolution.Update(clock.getWorkTime() * 1000.0f));
+}
+
+void Engine::SetDynamicResolution(float budgetMs)
+{
+    if (budgetMs > 0) resolution.Enable(budgetMs);
+    else resolution.Disable(renderer.GetRenderScale());
+}
+
+void Engine::SetRenderScale(float scale)
+{
+    resolution.Disable(scale);
+    renderer.SetRenderScale(resolution.GetScale());
+}
+
+float Engine::GetRenderScale() const {return renderer.GetRenderScale();}
+
+void Engine::ClearScreen() {PROFILE_SCOPE("Clear"); renderer.Clear();}
 
-void Engine::RenderBackground() {renderer.RenderBackGround();}
+void Engine::RenderBackground() {PROFILE_SCOPE("Background"); renderer.RenderBackGround();}
 
-void Engine::RenderRayCasting() {renderer.RayCasting();}
+void Engine::RenderRayCasting() {PROFILE_SCOPE("RayCasting"); renderer.RayCasting();}
 
-void Engine::RenderSprites() {renderer.RenderSprites();}
+void Engine::RenderSprites() {PROFILE_SCOPE("Sprites"); renderer.RenderSprites();}
 
-void Engine::Render2DMap(float scale) {renderer.Render2DMap(scale);}
+void Engine::Render2DMap(float scale) {PROFILE_SCOPE("2DMap"); renderer.Render2DMap(scale);}
 
-void Engine::Render2DPlayer(float scale) {renderer.Render2DPlayer(scale);}
+void Engine::Render2DMarkers(float scale) {PROFILE_SCOPE("2DMarkers"); renderer.Render2DMarkers(scale);}
 
-void Engine::Render2DSprites(float scale) {renderer.Render2DSprites(scale);}
+void Engine::RenderWeapon() {PROFILE_SCOPE("Weapon"); if (renderView) ui.RenderWeapon(renderView->weapon);}
 
-void Engine::RenderWeapon() {ui.RenderWeapon();}
+void Engine::RenderCrosshair() {PROFILE_SCOPE("Crosshair"); ui.RenderCrosshair();}
 
-void Engine::RenderCrosshair() {ui.RenderCrosshair();}
+void Engine::RenderHpEffect() {PROFILE_SCOPE("HpEffect"); if (renderView) ui.HpEffect(renderView->playerHp);}
 
-void Engine::RenderHpEffect() {ui.HpEffect(player.GetHp());}
+void Engine::RenderHud() {PROFILE_SCOPE("Hud"); if (renderView) renderer.RenderHud(clock.getFPS(), renderView->round, renderView->score);}
 
 void Engine::RenderEndScreen(int round, int maxScore) {renderer.RenderEnd(round, maxScore);}
 
-void Engine::DisplayFrame() {renderer.Display();}
+void Engine::RenderProfiler() {renderer.RenderProfilerOverlay();}
+
+void Engine::DisplayFrame() {PROFILE_SCOPE("Present"); renderer.Display();}
 
 // ===== AUDIO =====
 
-void Engine::LoadSounds(const std::string& path) {audioManager.LoadSound(path);}
+void Engine::LoadSounds(const std::string& path)
+{
+    assets.Queue(ASSET_SOUND, AssetLoader::ListFiles(path, {".wav"}), [this](std::vector<Asset>& group) {
+        for (auto& a : group) audioManager.AddSound(fs::path(a.path).stem().string(), a.chunk);
+    });
+}
+
+void Engine::LoadMusic(const std::string& path)
+{
+    assets.Queue(ASSET_MUSIC, AssetLoader::ListFiles(path, {".mp3", ".ogg", ".wav"}), [this](std::vector<Asset>& group) {
+        for (auto& a : group) audioManager.AddMusic(fs::path(a.path).stem().string(), a.music);
+    });
+}
 
-void Engine::LoadMusic(const std::string& path) {audioManager.LoadMusic(path);}
+SoundHandle Engine::GetSound(const std::string& name) const {return audioManager.GetSound(name);}
 
-void Engine::PlaySound(const std::string& name, int loops) {audioManager.PlaySound(name, loops);}
+void Engine::SetSoundParams(SoundHandle sound, int priority, int maxInstances) {audioManager.SetSoundParams(sound, priority, maxInstances);}
 
-void Engine::PlayExclusiveSound(const std::string& name, int loops) {audioManager.PlayExclusiveSound(name, loops);}
+void Engine::PlaySound(SoundHandle sound, int loops) {audioManager.PlaySound(sound, loops);}
+
+void Engine::PlayExclusiveSound(SoundHandle sound, int loops) {audioManager.PlayExclusiveSound(sound, loops);}
 
 void Engine::PlayMusic(const std::string& name, int loops) {audioManager.PlayMusic(name, loops);}
 
 // ===== UI/WEAPONS =====
 
-void Engine::LoadWeapon(const std::string& name, int frames, float delay, float xOffset, float scale) {ui.LoadWeapon(name, frames, delay, xOffset, scale);}
+void Engine::LoadWeapon(const std::string& name, int frames, float delay, float xOffset, float scale)
+{
+    assets.Queue(ASSET_IMAGE, Interface::GetWeaponFiles(name), [=](std::vector<Asset>& group) {
+        std::vector<SDL_Surface*> pixels;
+        for (auto& a : group) pixels.push_back(a.pixels);
+        ui.AddWeapon(pixels, frames, delay, xOffset, scale);
+    });
+}
 
 void Engine::ChangeWeapon(int weaponIndex) {ui.ChangeWeapon(weaponIndex);}
 
@@ -74,9 +120,32 @@ void Engine::UpdateWeaponAnimation() {ui.UpdateAnimation();}
 
 // ===== TEXTURES =====
 
-void Engine::LoadBackgroundTexture() {renderer.LoadBG();}
+void Engine::LoadBackgroundTexture()
+{
+    assets.Queue(ASSET_IMAGE, {"res/bg/sky.png"}, [this](std::vector<Asset>& group) {renderer.AddTexture(group[0].pixels, group[0].path);});
+}
+
+void Engine::LoadTextures(const std::string& path)
+{
+    assets.Queue(ASSET_IMAGE, AssetLoader::ListFiles(path), [this, path](std::vector<Asset>& group) {
+        int cnt = 0;
+        for (auto& a : group) cnt += renderer.AddTexture(a.pixels, a.path);
+        std::cout << "Loaded " << cnt << " textures from " << path << ".\n";
+    });
+}
 
-void Engine::LoadTextures(const std::string& path) {renderer.LoadTextures(path);}
+void Engine::FinishLoading()
+{
+    // Workers decode; this thread creates the textures as groups complete and draws the progress bar
+    assets.Start();
+    while (!assets.CommitReady())
+    {
+        SDL_PumpEvents();
+        renderer.RenderLoading(assets.GetProgress());
+        SDL_Delay(4);
+    }
+    assets.Finish();
+}
 
 void Engine::ClearTextures() {renderer.ClearTex();}
 
@@ -94,9 +163,14 @@ float Engine::GetPlayerHp() const {return player.GetHp();}
 
 void Engine::SetPlayerHp(float hp) {player.SetHp(hp);}
 
-void Engine::SetPlayerPos(std::pair<float, float> pos) {player.ChangePos(pos);}
+void Engine::SetPlayerPos(std::pair<float, float> pos)
+{
+    // Teleports must not be blended with the old position
+    player.ChangePos(pos);
+    player.SavePose();
+}
 
-void Engine::RotatePlayer(float angle) {player.Rotate(angle);}
+void Engine::RotatePlayer(float angle, bool blend) {player.Rotate(angle, blend);}
 
 void Engine::PlayerLookUp() {player.LookUp();}
 
@@ -108,37 +182,90 @@ void Engine::PlayerTakeDamage(float damage) {player.TakeDamage(damage);}
 
 void Engine::MovePlayer(int dir) {physicsManager.MovePly(dir);}
 
-void Engine::MoveSprite(int index, int dir) {physicsManager.MoveSpt(index, dir);}
+void Engine::MoveSprites() {PROFILE_SCOPE("SpriteMove"); physicsManager.MoveAllSpt();}
 
-Sprites* Engine::PerformPlayerRaycast() {return physicsManager.Praycast();}
+void Engine::PerformPlayerHitscan(int rays, float spread, std::vector<HitscanResult>& out) {physicsManager.PlayerHitscan(rays, spread, out);}
 
 bool Engine::PerformSpriteRaycast(int index, float fov, float depth) {return physicsManager.Sraycast(index, fov, depth);}
 
-void Engine::UpdateAllSpritesPhysics() {physicsManager.UpdateAllSpt();}
+void Engine::PerformSpriteSight(float fov, float depth, std::vector<uint8_t>& out) {PROFILE_SCOPE("Sight"); physicsManager.SraycastAll(fov, depth, out);}
+
+void Engine::UpdateAllSpritesPhysics() {PROFILE_SCOPE("Broadphase"); physicsManager.UpdateAllSpt();}
 
 // ===== SPRITES =====
 
-void Engine::AddSprite(const std::string& name, std::pair<int, int> pos, float angle,
-                      float speed, float rotSpeed, bool rigid, bool visible,
-                      int defaultState, float damage, float range)
+int Engine::AddSprite(int type, std::pair<float, float> pos, float angle)
 {
-    sprites.push_back(Sprites(pos.first, pos.second, angle, speed, rotSpeed,
-                             rigid, visible, defaultState, renderer.GetTexSize(),
-                             name, 100, damage, range));
-    renderer.LoadTextures("res/sprites/" + name);
+    // Runs on the simulation thread, so only the texture base cached by PreloadSprites is read here
+    if (enemyTexBase[type] < 0) std::cerr << "Sprite sheets for " << GetEnemyType(type).name << " are not loaded" << std::endl;
+    return sprites.Add(type, pos.first, pos.second, angle);
 }
 
-void Engine::ClearSprites() {sprites.clear();}
+void Engine::PreloadSprites(int type)
+{
+    const EnemyTypeInfo& info = GetEnemyType(type);
+    std::vector<std::string> sheets(info.sheets, info.sheets + STATE_COUNT);
+    std::vector<int> frames(info.frames, info.frames + STATE_COUNT);
+    std::string folder = std::string("res/sprites/") + info.name;
+    int texBase = renderer.FindTextures(folder);
+    if (texBase >= 0) // already loaded, only AddFolder loads a folder
+    {
+        enemyTexBase[type] = texBase;
+        return;
+    }
+    for (auto& sheet : sheets) sheet = folder + "/" + sheet;
+    assets.Queue(ASSET_SHEET, sheets, [this, type, folder, frames](std::vector<Asset>& group) {
+        std::vector<SDL_Surface*> pixels;
+        for (auto& a : group) pixels.push_back(a.pixels);
+        enemyTexBase[type] = renderer.AddFolder(folder, pixels, frames);
+    });
+}
 
-int Engine::GetSpriteCount() const {return static_cast<int>(sprites.size());}
+void Engine::ClearSprites() {sprites.Clear();}
 
-Sprites& Engine::GetSprite(int index) {return sprites[index];}
+void Engine::PublishSnapshot(int round, int score)
+{
+    WorldSnapshot& snap = snapshots.WriteSlot();
+    snap.round = round;
+    snap.score = score;
+    snap.prevPlayerX = player.GetPrevX();
+    snap.prevPlayerY = player.GetPrevY();
+    snap.playerX = player.GetX();
+    snap.playerY = player.GetY();
+    snap.prevPlayerAngle = player.GetPrevA();
+    snap.playerAngle = player.GetA();
+    snap.playerPitch = player.GetPitch();
+    snap.playerHp = player.GetHp();
+    snap.alpha = clock.getAlpha();
+    snap.weapon = ui.GetView();
+
+    snap.sprites.resize(sprites.Size());
+    for (int i = 0; i < sprites.Size(); i++)
+    {
+        SpriteView& v = snap.sprites[i];
+        int texBase = enemyTexBase[sprites.type[i]];
+        v.prevX = sprites.prevX[i];
+        v.prevY = sprites.prevY[i];
+        v.x = sprites.posX[i];
+        v.y = sprites.posY[i];
+        v.prevAngle = sprites.prevAngle[i];
+        v.angle = sprites.angle[i];
+        v.texIndex = texBase < 0 ? -1 : texBase + sprites.state[i];
+        v.state = sprites.state[i];
+        v.aniCnt = sprites.aniCnt[i];
+        v.visible = sprites.IsVisible(i);
+        v.dead = sprites.IsDead(i);
+    }
+    snapshots.Publish();
+}
 
-const std::vector<Sprites>& Engine::GetSprites() const {return sprites;}
+int Engine::GetSpriteCount() const {return sprites.Size();}
 
-void Engine::UpdateSpriteStates() {for (auto& sprite : sprites) sprite.UpdateSprite();}
+Sprites& Engine::GetSprites() {return sprites;}
 
-void Engine::UpdateSpriteAnimations() {for (auto& sprite : sprites) sprite.UpdateAnimation();}
+void Engine::UpdateSpriteStates() {PROFILE_SCOPE("SpriteStates"); sprites.UpdateStates();}
+
+void Engine::UpdateSpriteAnimations() {PROFILE_SCOPE("SpriteAnims"); sprites.UpdateAnimations();}
 
 // ===== MAP =====
 
@@ -148,12 +275,35 @@ int Engine::GetMapRows() const {return worldMap.GetRow();}
 
 int Engine::GetMapCols() const {return worldMap.GetCol();}
 
+const Map& Engine::GetMap() const {return worldMap;}
+
+// ===== PROFILER =====
+
+void Engine::EndProfilerFrame() {Profiler::Instance().EndFrame();}
+
+void Engine::ToggleProfilerOverlay() {Profiler::Instance().ToggleOverlay();}
+
+void Engine::WriteProfile(const std::string& path) {Profiler::Instance().WriteCSV(path);}
+
 // ===== CLOCK =====
 
 void Engine::Tick(float targetFPS) {clock.tick(targetFPS);}
 
+bool Engine::StepSimulation()
+{
+    audioManager.Flush(); // sounds queued by the previous tick
+    if (!clock.stepTick()) return false;
+    player.SavePose();
+    sprites.SavePoses();
+    return true;
+}
+
+void Engine::SetTickRate(int hz) {clock.setTickRate(hz);}
+
 float Engine::GetDeltaTime() const {return clock.getDeltaTime();}
 
+void Engine::SetFixedDelta(float dt) {clock.setFixedDelta(dt);}
+
 // ===== CLEANUP =====
 
 void Engine::Cleanup()
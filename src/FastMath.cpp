@@ -0,0 +1,113 @@
+#include "FastMath.h"
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FASTMATH_SSE2
+#endif
+
+namespace FastMath
+{
+    static float sinTableData[(1 << SIN_TABLE_BITS) + 1];
+
+    static const float* BuildSinTable()
+    {
+        for (int i = 0; i <= (1 << SIN_TABLE_BITS); i++)
+            sinTableData[i] = (float)std::sin(i * (2.0 * 3.14159265358979323846 / (1 << SIN_TABLE_BITS)));
+        return sinTableData;
+    }
+
+    const float* sinTable = BuildSinTable();
+
+#ifdef FASTMATH_SSE2
+    // Same steps as the scalar WrapAngle / Sin, four lanes at a time
+    static inline __m128 Wrap4(__m128 x)
+    {
+        __m128 k = _mm_mul_ps(_mm_add_ps(x, _mm_set1_ps(PI_F)), _mm_set1_ps(INV_TWO_PI_F));
+        // floor(k) with SSE2: truncate, then subtract one where truncation rounded up
+        __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(k));
+        t = _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, k), _mm_set1_ps(1.0f)));
+        return _mm_sub_ps(_mm_sub_ps(x, _mm_mul_ps(t, _mm_set1_ps(TWO_PI_HI))), _mm_mul_ps(t, _mm_set1_ps(TWO_PI_LO)));
+    }
+
+    static inline __m128 Sin4(__m128 x)
+    {
+        const __m128 pi = _mm_set1_ps(PI_F);
+        const __m128 halfPi = _mm_set1_ps(HALF_PI_F);
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+
+        x = Wrap4(x);
+        __m128 sign = _mm_and_ps(x, signMask);
+        __m128 ax = _mm_andnot_ps(signMask, x);
+        __m128 fold = _mm_cmpgt_ps(ax, halfPi);
+        ax = _mm_or_ps(_mm_and_ps(fold, _mm_sub_ps(pi, ax)), _mm_andnot_ps(fold, ax));
+        x = _mm_or_ps(ax, sign);
+
+        __m128 x2 = _mm_mul_ps(x, x);
+        __m128 p = _mm_set1_ps(-2.5052108e-8f);
+        p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(2.7557319e-6f));
+        p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(-1.9841270e-4f));
+        p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(8.3333331e-3f));
+        p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(-1.6666667e-1f));
+        p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(1.0f));
+        return _mm_mul_ps(x, p);
+    }
+
+    static inline __m128 Atan24(__m128 y, __m128 x)
+    {
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+        const __m128 zero = _mm_setzero_ps();
+        __m128 ax = _mm_andnot_ps(signMask, x);
+        __m128 ay = _mm_andnot_ps(signMask, y);
+        __m128 mx = _mm_max_ps(ax, ay);
+        __m128 mn = _mm_min_ps(ax, ay);
+        __m128 nonZero = _mm_cmpgt_ps(mx, zero);
+        __m128 z = _mm_and_ps(nonZero, _mm_div_ps(mn, _mm_or_ps(_mm_and_ps(nonZero, mx), _mm_andnot_ps(nonZero, _mm_set1_ps(1.0f)))));
+
+        __m128 z2 = _mm_mul_ps(z, z);
+        __m128 r = _mm_set1_ps(-0.01172120f);
+        r = _mm_add_ps(_mm_mul_ps(r, z2), _mm_set1_ps(0.05265332f));
+        r = _mm_add_ps(_mm_mul_ps(r, z2), _mm_set1_ps(-0.11643287f));
+        r = _mm_add_ps(_mm_mul_ps(r, z2), _mm_set1_ps(0.19354346f));
+        r = _mm_add_ps(_mm_mul_ps(r, z2), _mm_set1_ps(-0.33262347f));
+        r = _mm_add_ps(_mm_mul_ps(r, z2), _mm_set1_ps(0.99997726f));
+        r = _mm_mul_ps(r, z);
+
+        __m128 steep = _mm_cmpgt_ps(ay, ax);
+        r = _mm_or_ps(_mm_and_ps(steep, _mm_sub_ps(_mm_set1_ps(HALF_PI_F), r)), _mm_andnot_ps(steep, r));
+        __m128 left = _mm_cmplt_ps(x, zero);
+        r = _mm_or_ps(_mm_and_ps(left, _mm_sub_ps(_mm_set1_ps(PI_F), r)), _mm_andnot_ps(left, r));
+        __m128 below = _mm_cmplt_ps(y, zero);
+        return _mm_or_ps(r, _mm_and_ps(below, signMask));
+    }
+#endif
+
+    void SinCos(const float* angles, float* sinOut, float* cosOut, int count)
+    {
+        int i = 0;
+#ifdef FASTMATH_SSE2
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 a = _mm_loadu_ps(angles + i);
+            __m128 s = Sin4(a);
+            __m128 c = Sin4(_mm_add_ps(Wrap4(a), _mm_set1_ps(HALF_PI_F)));
+            _mm_storeu_ps(sinOut + i, s);
+            _mm_storeu_ps(cosOut + i, c);
+        }
+#endif
+        for (; i < count; i++)
+        {
+            float a = angles[i];
+            sinOut[i] = Sin(a);
+            cosOut[i] = Cos(a);
+        }
+    }
+
+    void Atan2(const float* y, const float* x, float* out, int count)
+    {
+        int i = 0;
+#ifdef FASTMATH_SSE2
+        for (; i + 4 <= count; i += 4)
+            _mm_storeu_ps(out + i, Atan24(_mm_loadu_ps(y + i), _mm_loadu_ps(x + i)));
+#endif
+        for (; i < count; i++) out[i] = Atan2(y[i], x[i]);
+    }
+}
@@ -0,0 +1,89 @@
+#include "FlowField.h"
+#include <algorithm>
+#include <cstddef>
+
+void FlowField::Init(const Map& mp)
+{
+    map = &mp;
+    rows = mp.GetRow();
+    cols = mp.GetCol();
+    target = -1;
+    dist.assign(rows * cols, -1);
+    next.assign(rows * cols, -1);
+    queue.reserve(rows * cols);
+}
+
+bool FlowField::Update(std::pair<int, int> targetCell)
+{
+    if (!map || !map->InBounds(targetCell.first, targetCell.second)) return false;
+    int id = targetCell.first * cols + targetCell.second;
+    if (id == target) return false;
+    target = id;
+    Rebuild();
+    return true;
+}
+
+void FlowField::Rebuild()
+{
+    std::fill(dist.begin(), dist.end(), -1);
+    std::fill(next.begin(), next.end(), -1);
+    queue.clear();
+    if (map->IsWallUnchecked(target / cols, target % cols)) return;
+
+    // 4-neighbour BFS from the target outward
+    const int dy[] = {-1, 1, 0, 0};
+    const int dx[] = {0, 0, -1, 1};
+    dist[target] = 0;
+    queue.push_back(target);
+    for (size_t head = 0; head < queue.size(); head++)
+    {
+        int cell = queue[head];
+        int cy = cell / cols, cx = cell % cols;
+        for (int i = 0; i < 4; i++)
+        {
+            int ny = cy + dy[i], nx = cx + dx[i];
+            if (ny < 0 || ny >= rows || nx < 0 || nx >= cols) continue;
+            int n = ny * cols + nx;
+            if (dist[n] >= 0 || map->IsWallUnchecked(ny, nx)) continue;
+            dist[n] = dist[cell] + 1;
+            queue.push_back(n);
+        }
+    }
+
+    // Steepest descent per cell; diagonals only when both side cells are open,
+    // so enemies don't cut wall corners
+    const int ddy[] = {-1, 1, 0, 0, -1, -1, 1, 1};
+    const int ddx[] = {0, 0, -1, 1, -1, 1, -1, 1};
+    for (int cell : queue)
+    {
+        if (cell == target) continue;
+        int cy = cell / cols, cx = cell % cols;
+        int best = -1, bestDist = dist[cell];
+        for (int i = 0; i < 8; i++)
+        {
+            int ny = cy + ddy[i], nx = cx + ddx[i];
+            if (ny < 0 || ny >= rows || nx < 0 || nx >= cols) continue;
+            int n = ny * cols + nx;
+            if (dist[n] < 0 || dist[n] >= bestDist) continue;
+            if (i >= 4 && (dist[cy * cols + nx] < 0 || dist[ny * cols + cx] < 0)) continue;
+            best = n;
+            bestDist = dist[n];
+        }
+        next[cell] = best;
+    }
+}
+
+int FlowField::GetDistance(int row, int col) const
+{
+    if (!map || !map->InBounds(row, col)) return -1;
+    return dist[row * cols + col];
+}
+
+bool FlowField::GetNextCell(int row, int col, std::pair<int, int>& cell) const
+{
+    if (!map || !map->InBounds(row, col)) return false;
+    int n = next[row * cols + col];
+    if (n < 0) return false;
+    cell = {n / cols, n % cols};
+    return true;
+}
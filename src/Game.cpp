@@ -12,14 +12,17 @@ bool Game::Init(const char* title, int w, int h, bool fullscreen, bool resizable
     maxScore = 0;
     Round = 0;
     MouseClick = false;
+    if (!fixedSeed) rng.seed(static_cast<unsigned int>(std::chrono::high_resolution_clock::now().time_since_epoch().count()));
     SDL_SetRelativeMouseMode(SDL_TRUE);
 
     // Initialize engine modules
     engine.InitUI();
     engine.InitAudio();
     engine.InitMap(miniMap);
+    flowField.Init(engine.GetMap());
     engine.InitPlayer(GetRandomEmptyPosF(), 0.0f, 5.0f, 100.0f);
     engine.InitRenderer(title, w, h, fullscreen, resizable);
+    if (FPS > 0) engine.SetDynamicResolution(1000.0f / FPS); // shrink the render target rather than drop frames
 
     // Setup connections between modules
     engine.SetupConnections();
@@ -31,12 +34,22 @@ bool Game::Init(const char* title, int w, int h, bool fullscreen, bool resizable
     engine.LoadWeapon("handgun", HANDGUN_TOTAL_FRAMES, HANDGUN_FRAME_DELAY, HANDGUN_X_OFFSET, HANDGUN_SCALE);
     engine.LoadSounds("res/sound");
     engine.LoadMusic("res/music");
+    // Sprite sheets are created here because waves spawn on the simulation thread
+    for (int type = 0; type < ENEMY_TYPE_COUNT; type++) engine.PreloadSprites(type);
+    engine.FinishLoading();
+    sndShotgun = engine.GetSound("shotgun");
+    sndPlayerPain = engine.GetSound("player_pain");
+    engine.SetSoundParams(sndPlayerPain, 1, 2); // every attacker in a wave would otherwise pile up
     engine.UpdateAllSpritesPhysics();
 
+    engine.PublishSnapshot(Round, 0);
+    simThread = std::thread(&Game::SimulationLoop, this);
     return true;
 }
 
-void Game::RebuildData()
+void Game::RebuildData() {StartWave(Round, Round);} // soldiers only spawn through explicit StartWave calls (benchmark --soldier)
+
+void Game::StartWave(int cacodemons, int cyberdemons, int soldiers)
 {
     // Reset game state
     pausing = false;
@@ -46,29 +59,24 @@ void Game::RebuildData()
     engine.SetPlayerPos(GetRandomEmptyPosF());
     engine.SetPlayerHp(100);
 
-    // Clear and reload resources
+    // Sprite sheets and wall textures stay cached across rounds
     engine.ClearSprites();
-    engine.ClearTextures();
-    engine.LoadBackgroundTexture();
-    engine.LoadTextures("res/texture-doomstyle");
 
-    // Spawn enemies based on round
-    for(int i = 1; i <= Round; i++)
-    {
-        AddSprite("cacodemon", GetRandomEmptyPosF(), 0, 1, 3, 1, 1, 1, 0.2, 1.5);
-        AddSprite("cyberdemon", GetRandomEmptyPosF(), 0, 1, 3, 1, 1, 1, 0.2, 5);
-    }
+    for(int i = 0; i < cacodemons; i++) AddSprite(ENEMY_CACODEMON, GetRandomEmptyPosF());
+    for(int i = 0; i < cyberdemons; i++) AddSprite(ENEMY_CYBERDEMON, GetRandomEmptyPosF());
+    for(int i = 0; i < soldiers; i++) AddSprite(ENEMY_SOLDIER, GetRandomEmptyPosF());
     engine.UpdateAllSpritesPhysics();
 }
 
-void Game::AddSprite(std::string name, std::pair<int, int> pos, float a, float s, float rs, bool rg, bool vs, int defaultState, float dm, float rag)
+void Game::AddSprite(int type, std::pair<float, float> pos)
 {
-    engine.AddSprite(name, pos, a, s, rs, rg, vs, defaultState, dm, rag);
+    engine.AddSprite(type, pos);
     MonCnt++;
 }
 
 void Game::HandleEvent()
 {
+    PROFILE_SCOPE("Events");
     SDL_Event event;
     while (SDL_PollEvent(&event))
     {
@@ -85,8 +93,8 @@ void Game::HandleEvent()
                     int dy = event.motion.yrel;
                     float sensitivity = 0.0015f;
 
-                    if (dx != 0)
-                        engine.RotatePlayer(dx * sensitivity);
+                    if (dx != 0) // shows at once instead of being blended over the next tick
+                        engine.RotatePlayer(dx * sensitivity, false);
 
                     if (dy < 0) {
                         engine.PlayerLookUp();
@@ -101,6 +109,9 @@ void Game::HandleEvent()
                     SDL_SetRelativeMouseMode(SDL_FALSE);
                     MouseFree = true;
                 }
+                if (event.key.keysym.sym == SDLK_F3) {
+                    engine.ToggleProfilerOverlay();
+                }
                 if (event.key.keysym.sym == SDLK_SPACE && pausing) {
                     Round = 1;
                     RebuildData();
@@ -133,89 +144,155 @@ void Game::HandleEvent()
 
 void Game::Update()
 {
+    PROFILE_SCOPE("Update");
     // Check player death
     if(engine.GetPlayerHp() <= 0) pausing = true;
 
-    // Handle player input
-    SDL_PumpEvents();
-    const Uint8* keystates = SDL_GetKeyboardState(NULL);
+    // Re-bucket sprites once per tick, collision queries below read this grid
+    engine.UpdateAllSpritesPhysics();
 
     // Movement
-    if(keystates[SDL_SCANCODE_W]) engine.MovePlayer(Forward);
-    if(keystates[SDL_SCANCODE_S]) engine.MovePlayer(Backward);
-    if(keystates[SDL_SCANCODE_A]) engine.MovePlayer(Left);
-    if(keystates[SDL_SCANCODE_D]) engine.MovePlayer(Right);
+    if(input.forward) engine.MovePlayer(Forward);
+    if(input.backward) engine.MovePlayer(Backward);
+    if(input.left) engine.MovePlayer(Left);
+    if(input.right) engine.MovePlayer(Right);
 
     // Rotation
-    if (keystates[SDL_SCANCODE_LEFT]) engine.RotatePlayer(-0.05f); // Assuming default rotation speed
-    if (keystates[SDL_SCANCODE_RIGHT]) engine.RotatePlayer(0.05f);
-    if (keystates[SDL_SCANCODE_UP]) engine.PlayerLookUp();
-    if (keystates[SDL_SCANCODE_DOWN]) engine.PlayerLookDown();
+    if (input.turnLeft) engine.RotatePlayer(-0.05f); // Assuming default rotation speed
+    if (input.turnRight) engine.RotatePlayer(0.05f);
+    if (input.turn != 0.0f) engine.RotatePlayer(input.turn);
+    if (input.lookUp) engine.PlayerLookUp();
+    if (input.lookDown) engine.PlayerLookDown();
 
     // Update sprites
-    int deadCount = 0;
-    const auto& sprites = engine.GetSprites();
-    for(unsigned int i = 0; i < sprites.size(); i++)
-    {
-        if(sprites[i].IsDead()) deadCount++;
-    }
+    int deadCount = engine.GetSprites().CountDead();
     engine.UpdateSpriteStates();
     engine.UpdateSpriteAnimations();
 
     // Check for round completion
     if(deadCount == MonCnt)
     {
-        Round++;
-        RebuildData();
+        if (fixedWave) {if (MonCnt > 0) StartWave(waveCaco, waveCyber, waveSoldier);} // an empty wave stays empty
+        else
+        {
+            Round++;
+            RebuildData();
+        }
     }
     UpdateAI();
+    engine.MoveSprites();
 
     // Weapon switching
-    if (keystates[SDL_SCANCODE_1])
-    {
-        currentWeapon = 0;
-        engine.ChangeWeapon(0);
-    }
-    if (keystates[SDL_SCANCODE_2])
+    if (input.weapon >= 0)
     {
-        currentWeapon = 1;
-        engine.ChangeWeapon(1);
+        currentWeapon = input.weapon;
+        engine.ChangeWeapon(input.weapon);
     }
 
     // Shooting
     if (MouseClick && engine.IsWeaponAnimationDone())
     {
-        Sprites* target = engine.PerformPlayerRaycast();
-        if(target != nullptr && currentWeapon == 0) target->TakeDamage(30);
-        if(target != nullptr && currentWeapon == 1) target->TakeDamage(20);
+        if(currentWeapon == 0) engine.PerformPlayerHitscan(SHOTGUN_PELLETS, SHOTGUN_SPREAD, shotHits);
+        else engine.PerformPlayerHitscan(1, 0.0f, shotHits);
+        for (const auto& hit : shotHits)
+            if (hit.sprite >= 0) engine.GetSprites().TakeDamage(hit.sprite, currentWeapon == 0 ? SHOTGUN_DAMAGE : HANDGUN_DAMAGE);
 
         engine.RunShootAnimation();
 
-        if(currentWeapon == 0) engine.PlayExclusiveSound("shotgun", 0);
-        else if(currentWeapon == 1) engine.PlayExclusiveSound("shotgun", 0);
+        if(currentWeapon == 0) engine.PlayExclusiveSound(sndShotgun, 0);
+        else if(currentWeapon == 1) engine.PlayExclusiveSound(sndShotgun, 0);
 
         MouseClick = false;
     }
     engine.UpdateWeaponAnimation();
 }
 
+void Game::ReadKeyboard()
+{
+    SDL_PumpEvents();
+    const Uint8* keystates = SDL_GetKeyboardState(NULL);
+
+    input = InputState();
+    input.forward = keystates[SDL_SCANCODE_W];
+    input.backward = keystates[SDL_SCANCODE_S];
+    input.left = keystates[SDL_SCANCODE_A];
+    input.right = keystates[SDL_SCANCODE_D];
+    input.turnLeft = keystates[SDL_SCANCODE_LEFT];
+    input.turnRight = keystates[SDL_SCANCODE_RIGHT];
+    input.lookUp = keystates[SDL_SCANCODE_UP];
+    input.lookDown = keystates[SDL_SCANCODE_DOWN];
+    if (keystates[SDL_SCANCODE_1]) input.weapon = 0;
+    if (keystates[SDL_SCANCODE_2]) input.weapon = 1;
+}
+
 void Game::RenderGame()
 {
+    engine.BeginRenderFrame();
     engine.ClearScreen();
     engine.RenderBackground();
     engine.RenderRayCasting();
     engine.RenderSprites();
     engine.Render2DMap(10.0f);
-    engine.Render2DPlayer(10.0f);
-    engine.Render2DSprites(10.0f);
+    engine.Render2DMarkers(10.0f);
     engine.RenderWeapon();
     engine.RenderCrosshair();
     engine.RenderHpEffect();
+    engine.RenderHud();
+    engine.RenderProfiler();
     engine.DisplayFrame();
 }
 
+void Game::Simulate()
+{
+    while(!pausing && engine.StepSimulation()) Update();
+    engine.PublishSnapshot(Round, std::max(0, Round - 1)); // rounds cleared, as on the end screen
+}
+
+void Game::SimulationLoop()
+{
+    std::unique_lock<std::mutex> lock(simMtx);
+    while(true)
+    {
+        simCv.wait(lock, [&] { return simRequested || simQuit; });
+        if(simQuit) return;
+        lock.unlock();
+        Simulate();
+        lock.lock();
+        simRequested = false;
+        simCv.notify_all();
+    }
+}
+
+void Game::StartSimulation()
+{
+    if(!simThread.joinable())
+    {
+        Simulate();
+        return;
+    }
+    std::lock_guard<std::mutex> lock(simMtx);
+    simRequested = true;
+    simCv.notify_all();
+}
+
+void Game::FinishSimulation()
+{
+    std::unique_lock<std::mutex> lock(simMtx);
+    simCv.wait(lock, [&] { return !simRequested; });
+}
+
 void Game::Clean()
 {
+    if(simThread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(simMtx);
+            simQuit = true;
+        }
+        simCv.notify_all();
+        simThread.join();
+    }
+    engine.WriteProfile("profile.csv");
     engine.Cleanup();
     IMG_Quit();
     SDL_Quit();
@@ -229,25 +306,68 @@ void Game::Run()
         HandleEvent();
         if(!pausing)
         {
-            Update();
+            ReadKeyboard();
+            // The next ticks simulate on their own thread while this one draws the last snapshot;
+            // events and game state are only touched here after FinishSimulation
+            StartSimulation();
             RenderGame();
+            FinishSimulation();
+            engine.EndProfilerFrame();
         }
         else {
+            while(engine.StepSimulation()) {} // time spent paused is not simulated later
             maxScore = std::max(maxScore, Round - 1);
             engine.RenderEndScreen(Round - 1, maxScore);
         }
     }
 }
 
+void Game::SetFixedTimestep(float dt) {engine.SetFixedDelta(dt);}
+
+void Game::SetSeed(unsigned int seed)
+{
+    rng.seed(seed);
+    fixedSeed = true;
+}
+
+void Game::SetGodMode(bool on) {godMode = on;}
+
+void Game::WaitForMap() {engine.WaitForMap();}
+
+void Game::SetFixedWave(int cacodemons, int cyberdemons, int soldiers)
+{
+    fixedWave = true;
+    waveCaco = cacodemons, waveCyber = cyberdemons, waveSoldier = soldiers;
+    StartWave(cacodemons, cyberdemons, soldiers);
+}
+
+void Game::SetDynamicResolution(float budgetMs) {engine.SetDynamicResolution(budgetMs);}
+
+void Game::SetRenderScale(float scale) {engine.SetRenderScale(scale);}
+
+float Game::GetRenderScale() const {return engine.GetRenderScale();}
+
+void Game::StepFrame(const InputState& in)
+{
+    SDL_Event e;
+    while (SDL_PollEvent(&e)) {}
+
+    engine.Tick(0);
+    input = in;
+    if (in.fire) MouseClick = true;
+    if (godMode) engine.SetPlayerHp(100);
+    StartSimulation();
+    RenderGame();
+    FinishSimulation();
+    engine.EndProfilerFrame();
+}
+
 std::pair<float, float> Game::GetRandomEmptyPosF()
 {
     int rows = engine.GetMapRows();
     int cols = engine.GetMapCols();
     if (rows <= 0 || cols <= 0) return std::make_pair(-1.f, -1.f);
 
-    static std::mt19937 rng;
-    auto now = std::chrono::high_resolution_clock::now().time_since_epoch().count();
-    rng.seed(static_cast<unsigned int>(now));
     std::uniform_int_distribution<int> distRow(0, rows - 1);
     std::uniform_int_distribution<int> distCol(0, cols - 1);
 
@@ -295,181 +415,72 @@ std::pair<float, float> Game::GetRandomEmptyPosF()
     return std::make_pair(-1.f, -1.f);
 }
 
-int Game::CalculateHeuristic(std::pair<int, int> a, std::pair<int, int> b) {
-    return std::abs(a.first - b.first) + std::abs(a.second - b.second);
-}
-
-std::vector<std::pair<int, int>> Game::FindPathAStar(std::pair<int, int> start, std::pair<int, int> end) {
-    std::vector<Node*> openList;
-    std::vector<Node*> closedList;
-    std::vector<std::pair<int, int>> path;
-
-    Node* startNode = new Node(start.first, start.second, 0, CalculateHeuristic(start, end), nullptr);
-    openList.push_back(startNode);
-
-    while (!openList.empty()) {
-        auto it_current = openList.begin();
-        Node* currentNode = *it_current;
-        for (auto it = openList.begin(); it != openList.end(); ++it) {
-            if ((*it)->f() < currentNode->f()) {
-                currentNode = *it;
-                it_current = it;
-            }
-        }
-
-        if (currentNode->y == end.first && currentNode->x == end.second) {
-            Node* temp = currentNode;
-            while (temp != nullptr) {
-                path.push_back({temp->y, temp->x});
-                temp = temp->parent;
-            }
-            std::reverse(path.begin(), path.end());
-            break;
-        }
-
-        openList.erase(it_current);
-        closedList.push_back(currentNode);
-
-        int dy[] = {-1, 1, 0, 0};
-        int dx[] = {0, 0, -1, 1};
-
-        for (int i = 0; i < 4; ++i) {
-            std::pair<int, int> neighborPos = {currentNode->y + dy[i], currentNode->x + dx[i]};
-
-            if (engine.IsWall(neighborPos) || neighborPos.first < 0 || neighborPos.second < 0) {
-                continue;
-            }
-
-            bool inClosed = false;
-            for (Node* node : closedList) {
-                if (node->y == neighborPos.first && node->x == neighborPos.second) {
-                    inClosed = true;
-                    break;
-                }
-            }
-            if (inClosed) continue;
-
-            int gCost = currentNode->g + 1;
-            int hCost = CalculateHeuristic(neighborPos, end);
-            Node* neighborNode = new Node(neighborPos.first, neighborPos.second, gCost, hCost, currentNode);
-
-            bool inOpen = false;
-            for (Node* node : openList) {
-                if (node->y == neighborPos.first && node->x == neighborPos.second) {
-                    inOpen = true;
-                    if (gCost < node->g) {
-                        node->g = gCost;
-                        node->parent = currentNode;
-                    }
-                    delete neighborNode;
-                    break;
-                }
-            }
-            if (!inOpen) {
-                openList.push_back(neighborNode);
-            }
-        }
-    }
-
-    for (auto node : openList) delete node;
-    for (auto node : closedList) delete node;
-    return path;
-}
-
 void Game::UpdateAI()
 {
+    PROFILE_SCOPE("AI");
     const float SIGHT_FOV = PI / 2.0f;
     const float SIGHT_DEPTH = 20.0f;
-    const float MIN_WAYPOINT_DIST = 0.5f;
-    static int path_recalculation_timer = 0;
-    const int PATH_RECALC_COOLDOWN = 30;
     float dt = engine.GetDeltaTime();
     int playerGridX = static_cast<int>(engine.GetPlayerX());
     int playerGridY = static_cast<int>(engine.GetPlayerY());
 
-    path_recalculation_timer++;
+    // One shared field toward the player, rebuilt only when the player changes cell
+    flowField.Update({playerGridY, playerGridX});
 
-    for (int i = 0; i < engine.GetSpriteCount(); ++i)
-    {
-        auto& ent = engine.GetSprite(i);
-        if (ent.IsDead() || (ent.GetState() == 4 && !ent.CheckAni())) continue;
-        float ATTACK_RANGE = ent.range;
-        float DAMAGE = ent.damage;
+    // Sight is tested for every sprite in one batch; nothing moves until the AI pass is done
+    engine.PerformSpriteSight(SIGHT_FOV, SIGHT_DEPTH, sightMask);
 
-        float spriteX = ent.GetX();
-        float spriteY = ent.GetY();
+    Sprites& spt = engine.GetSprites();
+    for (int i = 0; i < spt.Size(); ++i)
+    {
+        spt.SetVelocity(i, 0, 0);
+        if (spt.IsDead(i) || (spt.state[i] == 4 && !spt.CheckAni(i))) continue;
+        const EnemyTypeInfo& info = spt.GetInfo(i);
+        float ATTACK_RANGE = info.range;
+        float DAMAGE = info.damage;
+
+        float spriteX = spt.posX[i];
+        float spriteY = spt.posY[i];
         float playerX = engine.GetPlayerX();
         float playerY = engine.GetPlayerY();
 
         float dx = playerX - spriteX;
         float dy = playerY - spriteY;
         float distanceToPlayer = std::sqrt(dx * dx + dy * dy);
-        bool canSeePlayer = engine.PerformSpriteRaycast(i, SIGHT_FOV, SIGHT_DEPTH);
+        bool canSeePlayer = sightMask[i];
 
         if (distanceToPlayer <= ATTACK_RANGE && canSeePlayer)
         {
-            ent.SetState(3);
-            if(!ent.CheckAni())
+            spt.SetState(i, 3);
+            if(!spt.CheckAni(i))
             {
                 engine.PlayerTakeDamage(DAMAGE);
-                engine.PlaySound("player_pain", 0);
+                engine.PlaySound(sndPlayerPain, 0);
             }
             continue;
         }
 
-        if (canSeePlayer) {
-            ent.path.clear();
-            float angleToPlayer = atan2(dy, dx);
-            float currentAngle = ent.GetA();
-            float angleDiff = angleToPlayer - currentAngle;
-            while (angleDiff <= -PI) angleDiff += 2 * PI;
-            while (angleDiff > PI) angleDiff -= 2 * PI;
-
-            float maxRotation = ent.GetR() * dt;
-            float rotation = std::max(-maxRotation, std::min(maxRotation, angleDiff));
-            ent.Rotate(rotation);
-
-            engine.MoveSprite(i, Forward);
-            ent.SetState(1);
-        }
-        else {
-            if (path_recalculation_timer >= PATH_RECALC_COOLDOWN) {
-                int spriteGridX = static_cast<int>(spriteX);
-                int spriteGridY = static_cast<int>(spriteY);
-                ent.path = FindPathAStar({spriteGridY, spriteGridX}, {playerGridY, playerGridX});
+        // Head straight for a visible player, otherwise follow the flow field
+        float targetX = playerX, targetY = playerY;
+        if (!canSeePlayer) {
+            std::pair<int, int> nextCell;
+            if (!flowField.GetNextCell(static_cast<int>(spriteY), static_cast<int>(spriteX), nextCell)) {
+                spt.SetState(i, info.defaultState);
+                continue;
             }
+            targetX = static_cast<float>(nextCell.second) + 0.5f;
+            targetY = static_cast<float>(nextCell.first) + 0.5f;
+        }
 
-            if (!ent.path.empty()) {
-                float targetX = static_cast<float>(ent.path[0].second) + 0.5f;
-                float targetY = static_cast<float>(ent.path[0].first) + 0.5f;
-                float dx_path = targetX - spriteX;
-                float dy_path = targetY - spriteY;
-                float distanceToWaypoint = std::sqrt(dx_path * dx_path + dy_path * dy_path);
-
-                if (distanceToWaypoint < MIN_WAYPOINT_DIST) {
-                    ent.path.erase(ent.path.begin());
-                    if (ent.path.empty()) continue;
-                }
-
-                float angleToTarget = atan2(dy_path, dx_path);
-                float currentAngle = ent.GetA();
-                float angleDiff = angleToTarget - currentAngle;
-                while (angleDiff <= -PI) angleDiff += 2 * PI;
-                while (angleDiff > PI) angleDiff -= 2 * PI;
-
-                float maxRotation = ent.GetR() * dt;
-                float rotation = std::max(-maxRotation, std::min(maxRotation, angleDiff));
-                ent.Rotate(rotation);
+        float angleToTarget = FastMath::Atan2(targetY - spriteY, targetX - spriteX);
+        float angleDiff = FastMath::WrapAngle(angleToTarget - spt.angle[i]);
 
-                engine.MoveSprite(i, Forward);
-                ent.SetState(1);
-            } else {
-                ent.SetState(ent.GetDefaultState());
-            }
-        }
-    }
+        float maxRotation = info.rotSpeed * dt;
+        float rotation = std::max(-maxRotation, std::min(maxRotation, angleDiff));
+        spt.Rotate(i, rotation);
 
-    if (path_recalculation_timer >= PATH_RECALC_COOLDOWN) {
-        path_recalculation_timer = 0;
+        // Physics integrates after the AI pass, see Update()
+        spt.SetVelocity(i, info.speed * FastMath::Cos(spt.angle[i]), info.speed * FastMath::Sin(spt.angle[i]));
+        spt.SetState(i, 1);
     }
 }
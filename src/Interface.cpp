@@ -1,40 +1,5 @@
 #include "Interface.h"
 
-void Interface::LoadTex(const std::string& fullPath)
-{
-    int cnt = 0;
-    std::cout << "Interface Loading... ";
-
-    if (!fs::exists(fullPath) || !fs::is_directory(fullPath)) {
-        std::cerr << "Cannot open folder: " << fullPath << "\n";
-        return;
-    }
-
-    std::vector<fs::path> files;
-    for (const auto& entry : fs::directory_iterator(fullPath)) {
-        if (!entry.is_regular_file()) continue;
-        files.push_back(entry.path());
-    }
-
-    std::sort(files.begin(), files.end());
-
-    int filesToLoad = std::min<int>(files.size(), 2);
-    for (int i = 0; i < filesToLoad; ++i) {
-        const auto& path = files[i];
-        SDL_Texture* texture = IMG_LoadTexture(renderer, path.string().c_str());
-        if (!texture) {
-            std::cerr << "Failed to load " << path << ": "
-                      << IMG_GetError() << "\n";
-            continue;
-        }
-        tex.push_back(texture);
-        cnt++;
-    }
-
-    std::cout << "Loaded " << cnt << " textures from " << fullPath << ".\n";
-}
-
-
 void Interface::GetRenderInfo(SDL_Renderer* rd, int w, int h)
 {
     renderer = rd;
@@ -56,7 +21,21 @@ bool Interface::Init()
     return true;
 }
 
+std::vector<std::string> Interface::GetWeaponFiles(const std::string& weaponName)
+{
+    std::vector<std::string> files = AssetLoader::ListFiles("res/weapon/" + weaponName);
+    if (files.size() > 2) files.resize(2);
+    return files;
+}
+
 void Interface::LoadWeapon(const std::string& weaponName, int totalFrames, int frameDelay, int xOffset, float scale)
+{
+    std::vector<SDL_Surface*> frames;
+    for (const auto& path : GetWeaponFiles(weaponName)) frames.push_back(AssetLoader::DecodeImage(path));
+    AddWeapon(frames, totalFrames, frameDelay, xOffset, scale);
+}
+
+void Interface::AddWeapon(const std::vector<SDL_Surface*>& frames, int totalFrames, int frameDelay, int xOffset, float scale)
 {
     WeaponInfo info;
     info.startIndex = tex.size();
@@ -65,9 +44,17 @@ void Interface::LoadWeapon(const std::string& weaponName, int totalFrames, int f
     info.screenXOffset = xOffset;
     info.scale = scale;
 
-    std::string fullPath = "res/weapon/" + weaponName;
-
-    LoadTex(fullPath);
+    for (SDL_Surface* pixels : frames)
+    {
+        if (!pixels) continue;
+        SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, pixels);
+        SDL_FreeSurface(pixels);
+        if (!texture) {
+            std::cerr << "Failed to create weapon texture: " << SDL_GetError() << "\n";
+            continue;
+        }
+        tex.push_back(texture);
+    }
 
     weapons.push_back(info);
 }
@@ -107,18 +94,27 @@ void Interface::UpdateAnimation()
     }
 }
 
-void Interface::RenderWeapon()
+WeaponView Interface::GetView() const
 {
-    if (!renderer || CurrentWeaponIndex >= weapons.size()) return;
+    WeaponView view;
+    view.index = CurrentWeaponIndex;
+    view.state = WEAPON_State;
+    view.frame = WEAPON_AniFrame_counter;
+    return view;
+}
 
-    WeaponInfo& currentWeapon = weapons[CurrentWeaponIndex];
+void Interface::RenderWeapon(const WeaponView& view)
+{
+    if (!renderer || view.index >= weapons.size()) return;
+
+    WeaponInfo& currentWeapon = weapons[view.index];
 
     SDL_Texture* renderTex = nullptr;
     SDL_Rect srcRect = { 0, 0, 0, 0 };
 
     int frameW, frameH;
 
-    if (WEAPON_State == 0)
+    if (view.state == 0)
     {
         unsigned int defaultTexIndex = currentWeapon.startIndex;
         if (defaultTexIndex < 0 || defaultTexIndex >= tex.size()) return;
@@ -143,7 +139,7 @@ void Interface::RenderWeapon()
         frameW = sheetW / currentWeapon.totalFrames;
         frameH = sheetH;
 
-        srcRect = {WEAPON_AniFrame_counter * frameW, 0, frameW, frameH};
+        srcRect = {view.frame * frameW, 0, frameW, frameH};
     }
 
     const float SCALE_FACTOR = currentWeapon.scale;
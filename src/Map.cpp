@@ -1,33 +1,85 @@
 #include "Map.h"
+#include <cmath>
 
 bool Map::Init (const std::vector<std::vector<int>>& miniMap)
 {
     rows = miniMap.size(), cols =  miniMap[0].size();
+    cells.assign(rows * cols, 0);
     for(int i = 0; i < rows; i++)
         for(int j = 0; j < cols; j++)
             if(miniMap[i][j])
-            {
-                std::pair<int, int> pos = {i, j};
-                worldMap[pos] = miniMap[i][j];
-            }
+                cells[i * cols + j] = CELL_WALL | (miniMap[i][j] & CELL_TEX_MASK);
+    pvs.Build(*this);
+    version++;
     return true;
 }
 
-std::map<std::pair<int, int>, int>* Map::GetMap() {return &worldMap;}
+bool Map::InBounds(int row, int col) const {return row >= 0 && row < rows && col >= 0 && col < cols;}
 
 bool Map::FindPos(std::pair<int, int> pos)  const
 {
-    if(worldMap.find(pos) != worldMap.end()) return true;
-    return false;
+    if(!InBounds(pos.first, pos.second)) return false;
+    return IsWallUnchecked(pos.first, pos.second);
+}
+
+int Map::GetVal(std::pair<int, int> pos) const
+{
+    if(!InBounds(pos.first, pos.second)) return 0;
+    return GetTexUnchecked(pos.first, pos.second);
 }
 
-int Map::GetVal(std::pair<int, int> pos)
+uint16_t Map::GetCell(int row, int col) const
 {
-    return worldMap[pos];
+    if(!InBounds(row, col)) return 0;
+    return cells[row * cols + col];
 }
 
+const std::vector<uint16_t>& Map::GetCells() const {return cells;}
+
 int Map::GetRow()  const{return rows;}
 
 int Map::GetCol()  const{return cols;}
 
+const PvsTable& Map::GetPvs() const {return pvs;}
+
+void Map::WaitPvs() {pvs.Wait();}
+
+// Single-pass grid DDA: steps cell by cell along (dirX, dirY) until a wall or the map edge
+bool Map::CastRay(float px, float py, float dirX, float dirY, RayHit& hit) const
+{
+    int mapX = (int)px, mapY = (int)py;
+    if(!InBounds(mapY, mapX)) return false;
+
+    float deltaX = (dirX == 0) ? 1e30f : std::fabs(1.0f / dirX);
+    float deltaY = (dirY == 0) ? 1e30f : std::fabs(1.0f / dirY);
+    int stepX, stepY;
+    float sideX, sideY;
+
+    if(dirX < 0) { stepX = -1; sideX = (px - mapX) * deltaX; }
+    else         { stepX = 1;  sideX = (mapX + 1.0f - px) * deltaX; }
+    if(dirY < 0) { stepY = -1; sideY = (py - mapY) * deltaY; }
+    else         { stepY = 1;  sideY = (mapY + 1.0f - py) * deltaY; }
+
+    bool vertical = false;
+    int maxSteps = rows + cols;
+    for(int step = 0; step < maxSteps; step++)
+    {
+        if(sideX < sideY) { sideX += deltaX; mapX += stepX; vertical = true; }
+        else              { sideY += deltaY; mapY += stepY; vertical = false; }
+
+        if(!InBounds(mapY, mapX)) return false;
+        if(!IsWallUnchecked(mapY, mapX)) continue;
+
+        hit.distance = vertical ? sideX - deltaX : sideY - deltaY;
+        hit.row = mapY;
+        hit.col = mapX;
+        hit.vertical = vertical;
+        hit.tex = GetTexUnchecked(mapY, mapX);
+        float wall = vertical ? py + hit.distance * dirY : px + hit.distance * dirX;
+        hit.wallX = wall - std::floor(wall);
+        return true;
+    }
+    return false;
+}
 
+int Map::GetVersion() const {return version;}
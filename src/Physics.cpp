@@ -1,26 +1,32 @@
 #include "Physics.h"
 
-void Physics::ImportEntity(Map& mp, Player& py, Clock& clk, std::vector<Sprites>& psl)
+void Physics::ImportEntity(Map& mp, Player& py, Clock& clk, Sprites& psl)
 {
     mainMap = &mp;
     mainPlayer = &py;
     MyClock = &clk;
     PhySptList = &psl;
+    sightGrid.Init(mp);
 }
 
 void Physics::UpdateAllSpt()
 {
-    SptManager.clear();
+    SptGrid.Init(mainMap->GetRow(), mainMap->GetCol());
+    const Sprites& spt = *PhySptList;
+    SptGrid.Begin(spt.Size());
+    for (int i = 0; i < spt.Size(); i++)
+        if (spt.flags[i] & SPRITE_RIGID) SptGrid.Insert(i, spt.posX[i], spt.posY[i]);
+    SptGrid.End();
+}
 
-    for (unsigned int i = 0; i < PhySptList->size(); i++)
-    {
-        auto& ent = (*PhySptList)[i];
-        int xmap = ent.GetX();
-        int ymap = ent.GetY();
-        auto& cellList = SptManager[{xmap, ymap}];
-        cellList.push_back(&ent);
-        ent.ListIt = std::prev(cellList.end());
-    }
+void Physics::QuerySprites(float x, float y, float radius, std::vector<int>& out) const
+{
+    SptGrid.QueryRadius(x, y, radius + GRID_SLACK, out);
+}
+
+void Physics::QuerySprites(float minX, float minY, float maxX, float maxY, std::vector<int>& out) const
+{
+    SptGrid.QueryAABB(minX - GRID_SLACK, minY - GRID_SLACK, maxX + GRID_SLACK, maxY + GRID_SLACK, out);
 }
 
 bool Physics::Check_wall(float x, float y)
@@ -45,55 +51,32 @@ bool Physics::Check_wall(float x, float y)
     return false;
 }
 
-void Physics::UpdateSpt(Sprites& spt)
+void Physics::MoveAllSpt()
 {
-    int Ox = spt.GetOldX();
-    int Oy = spt.GetOldY();
-    int Nx = spt.GetX();
-    int Ny = spt.GetY();
-
-    if (Ox != Nx || Oy != Ny)
+    Sprites& spt = *PhySptList;
+    float dt = MyClock->getDeltaTime();
+    for (int i = 0; i < spt.Size(); i++)
     {
-        auto itOld = SptManager.find({Ox, Oy});
-        if (itOld != SptManager.end())
+        if (spt.velX[i] == 0 && spt.velY[i] == 0) continue;
+        float newX = spt.posX[i] + spt.velX[i] * dt;
+        float newY = spt.posY[i] + spt.velY[i] * dt;
+
+        if (spt.flags[i] & SPRITE_RIGID)
         {
-            auto& lst = itOld->second;
-            if (spt.ListIt != lst.end())
-                lst.erase(spt.ListIt);
-            if (lst.empty())
-                SptManager.erase(itOld);
+            if (!Check_wall(newX, spt.posY[i]) &&
+                !CheckEnt(newX, spt.posY[i], mainPlayer->GetX(), mainPlayer->GetY()) &&
+                !CheckSptCollision(newX, spt.posY[i], i))
+                spt.posX[i] = newX;
+
+            if (!Check_wall(spt.posX[i], newY) &&
+                !CheckEnt(spt.posX[i], newY, mainPlayer->GetX(), mainPlayer->GetY()) &&
+                !CheckSptCollision(spt.posX[i], newY, i))
+                spt.posY[i] = newY;
         }
-
-        auto& newList = SptManager[{Nx, Ny}];
-        newList.push_back(&spt);
-        spt.ListIt = std::prev(newList.end());
+        else spt.posX[i] = newX, spt.posY[i] = newY;
     }
 }
 
-void Physics::MoveSpt(int index, int type)
-{
-    auto& ent = (*PhySptList)[index];
-    std::pair<float, float> newPos = MoveEnt(ent, type);
-    float newX = newPos.first;
-    float newY = newPos.second;
-
-    if (ent.CheckRigid())
-    {
-        if (!Check_wall(newX, ent.GetY()) &&
-            !CheckEnt(newX, ent.GetY(), mainPlayer->GetX(), mainPlayer->GetY()) &&
-            !(CheckSptCollision(newX, ent.GetY(), &ent)).size())
-            ent.ChangePos({newX, ent.GetY()});
-
-        if (!Check_wall(ent.GetX(), newY) &&
-            !CheckEnt(ent.GetX(), newY, mainPlayer->GetX(), mainPlayer->GetY()) &&
-            !(CheckSptCollision(ent.GetX(), newY, &ent)).size())
-            ent.ChangePos({ent.GetX(), newY});
-    }
-    else ent.ChangePos({newX, newY});
-
-    UpdateSpt(ent);
-}
-
 void Physics::MovePly(int type)
 {
     auto& ent = *mainPlayer;
@@ -102,40 +85,26 @@ void Physics::MovePly(int type)
     float newY = newPos.second;
 
     if (!Check_wall(newX, ent.GetY()) &&
-        !(CheckSptCollision(newX, ent.GetY(), nullptr)).size())
+        !CheckSptCollision(newX, ent.GetY(), -1))
         ent.ChangePos({newX, ent.GetY()});
 
     if (!Check_wall(ent.GetX(), newY) &&
-        !(CheckSptCollision(ent.GetX(), newY, nullptr)).size())
+        !CheckSptCollision(ent.GetX(), newY, -1))
         ent.ChangePos({ent.GetX(), newY});
 }
 
-std::vector<Sprites*> Physics::CheckSptCollision(float newX, float newY, Sprites* spt)
+bool Physics::CheckSptCollision(float newX, float newY, int self)
 {
-    std::vector<Sprites*> collided;
-    if (!PhySptList) return collided;
-
-    int xmap = (int)newX;
-    int ymap = (int)newY;
+    if (!PhySptList) return false;
 
-    for (int x = xmap - 1; x <= xmap + 1; x++)
+    queryBuf.clear();
+    QuerySprites(newX, newY, SPT_RADIUS, queryBuf);
+    for (int i : queryBuf)
     {
-        for (int y = ymap - 1; y <= ymap + 1; y++)
-        {
-            auto it = SptManager.find({x, y});
-            if (it != SptManager.end())
-            {
-                for (Sprites* sprite : it->second)
-                {
-                    if (sprite == spt) continue;
-                    if (sprite->CheckRigid() &&
-                        CheckEnt(newX, newY, sprite->GetX(), sprite->GetY()))
-                        collided.push_back(sprite);
-                }
-            }
-        }
+        if (i == self || i >= PhySptList->Size()) continue;
+        if (CheckEnt(newX, newY, PhySptList->posX[i], PhySptList->posY[i])) return true;
     }
-    return collided;
+    return false;
 }
 
 bool Physics::CheckEnt(float ax, float ay, float bx, float by)
@@ -143,150 +112,113 @@ bool Physics::CheckEnt(float ax, float ay, float bx, float by)
     float dx = bx - ax;
     float dy = by - ay;
     float dist2 = dx * dx + dy * dy;
-    float radius = 0.6f;
-    return dist2 < radius * radius;
+    return dist2 < SPT_RADIUS * SPT_RADIUS;
 }
 
-Sprites* Physics::Praycast()
+// Walks the tiles along the ray and tests the sprites bucketed around each one. A body of HIT_RADIUS
+// (plus the drift since the grid rebuild) always lies within one tile of its bucket, so the 3x3
+// buckets around the current tile hold every sprite the ray can hit there. The walk stops at the
+// first wall, or once the best hit lies before the end of the current tile.
+bool Physics::Hitscan(float ox, float oy, float dirX, float dirY, float maxDist, HitscanResult& hit)
 {
-    if (!mainMap || !mainPlayer || !PhySptList) return nullptr;
-
-    float px = mainPlayer->GetX();
-    float py = mainPlayer->GetY();
-    float pa = mainPlayer->GetA();
-    float FOV = PI / 3;
-    float HalfFOV = FOV / 2;
-
-    Sprites* target = nullptr;
-    float closestDist = 1e9f;
-
-    for (auto& s : *PhySptList)
+    hit = {-1, maxDist, ox + dirX * maxDist, oy + dirY * maxDist};
+    if (!mainMap || !PhySptList) return false;
+    int mapX = (int)ox, mapY = (int)oy;
+    if (ox < 0 || oy < 0 || !mainMap->InBounds(mapY, mapX)) return false;
+
+    const Sprites& spt = *PhySptList;
+    if ((int)hitStamp.size() < spt.Size()) hitStamp.resize(spt.Size(), 0);
+    stampId++;
+
+    float deltaX = (dirX == 0) ? 1e30f : std::fabs(1.0f / dirX);
+    float deltaY = (dirY == 0) ? 1e30f : std::fabs(1.0f / dirY);
+    int stepX = dirX < 0 ? -1 : 1, stepY = dirY < 0 ? -1 : 1;
+    float sideX = (dirX < 0 ? ox - mapX : mapX + 1.0f - ox) * deltaX;
+    float sideY = (dirY < 0 ? oy - mapY : mapY + 1.0f - oy) * deltaY;
+    float best = maxDist;
+    int target = -1;
+
+    for (;;)
     {
-        if (!s.IsDead())
+        queryBuf.clear();
+        SptGrid.QueryAABB(mapX - 1.0f, mapY - 1.0f, mapX + 1.0f, mapY + 1.0f, queryBuf);
+        for (int i : queryBuf)
         {
-            float dx = s.GetX() - px;
-            float dy = s.GetY() - py;
-            float dist = sqrtf(dx * dx + dy * dy);
-            if (dist < 0.1f) continue;
-
-            float dirToSpt = atan2f(dy, dx);
-            float diff = fabsf(pa - dirToSpt);
-            if (diff > PI) diff = 2 * PI - diff;
-            if (diff > HalfFOV) continue;
-
-            float xvert, yvert, xhor, yhor;
-            float d_vert = RayVert(dirToSpt, px, py, xvert, yvert);
-            float d_hor = RayHor(dirToSpt, px, py, xhor, yhor);
-            float wallDist = std::min(d_vert, d_hor);
-
-            if (wallDist > dist && dist < closestDist)
-            {
-                closestDist = dist;
-                target = &s;
-            }
+            if (i >= spt.Size() || hitStamp[i] == stampId) continue;
+            hitStamp[i] = stampId;
+            // Ray against circle, dir is unit length
+            float fx = ox - spt.posX[i], fy = oy - spt.posY[i];
+            float b = fx * dirX + fy * dirY;
+            float c = fx * fx + fy * fy - HIT_RADIUS * HIT_RADIUS;
+            float disc = b * b - c;
+            if (disc < 0) continue;
+            float t = std::max(-b - std::sqrt(disc), 0.0f);
+            if (-b + std::sqrt(disc) >= 0 && t < best) best = t, target = i;
         }
+
+        float tExit = std::min(sideX, sideY);
+        if (best <= tExit || tExit >= maxDist) break;
+        if (sideX < sideY) { mapX += stepX; sideX += deltaX; }
+        else               { mapY += stepY; sideY += deltaY; }
+        if (!mainMap->InBounds(mapY, mapX)) break;
+        if (mainMap->IsWallUnchecked(mapY, mapX)) { best = tExit, target = -1; break; }
     }
-    return target;
+
+    hit = {target, best, ox + dirX * best, oy + dirY * best};
+    return target >= 0;
 }
 
-bool Physics::Sraycast(int index, float SptFov, float maxDepth)
+void Physics::HitscanBatch(float ox, float oy, const float* angles, int count, float maxDist, HitscanResult* out)
 {
-    if (!mainMap || !mainPlayer || !PhySptList) return false;
-
-    auto& sp = (*PhySptList)[index];
-    float sx = sp.GetX();
-    float sy = sp.GetY();
-    float sa = sp.GetA();
-
-    float px = mainPlayer->GetX();
-    float py = mainPlayer->GetY();
-
-    float dx = px - sx;
-    float dy = py - sy;
-    float dist = sqrtf(dx * dx + dy * dy);
-    if (dist > maxDepth) return false;
-
-    float dirToPlayer = atan2f(dy, dx);
-    float diff = fabsf(sa - dirToPlayer);
-    if (diff > PI) diff = 2 * PI - diff;
-    if (diff > SptFov / 2.0f) return false;
-
-    float xvert, yvert, xhor, yhor;
-    float d_vert = RayVert(dirToPlayer, sx, sy, xvert, yvert);
-    float d_hor = RayHor(dirToPlayer, sx, sy, xhor, yhor);
-    float wallDist = std::min(d_vert, d_hor);
-
-    return wallDist > dist;
+    rayCos.resize(count);
+    raySin.resize(count);
+    FastMath::SinCos(angles, raySin.data(), rayCos.data(), count);
+    for (int k = 0; k < count; k++) Hitscan(ox, oy, rayCos[k], raySin[k], maxDist, out[k]);
 }
 
-float Physics::RayVert(float angle, float px, float py, float& xvert, float& yvert)
+void Physics::PlayerHitscan(int rays, float spread, std::vector<HitscanResult>& out)
 {
-    int xmap = (int)px;
-    int mpRows = mainMap->GetRow();
-    int mpCols = mainMap->GetCol();
-
-    float sin_a = std::sin(angle);
-    float cos_a = std::cos(angle);
-    float dx, dy, depth, Jumpdepth;
-
-    if (cos_a > 0) { xvert = xmap + 1; dx = 1; }
-    else { xvert = xmap - 0.00001f; dx = -1; }
-
-    depth = (xvert - px) / cos_a;
-    yvert = py + sin_a * depth;
-    dy = sin_a / cos_a * dx;
-    Jumpdepth = dx / cos_a;
-
-    std::pair<int, int> posvert = {(int)yvert, (int)xvert};
-    int maxSteps = mpRows * mpCols * 2;
-    int step = 0;
-
-    while (!mainMap->FindPos(posvert) && step < maxSteps)
-    {
-        xvert += dx;
-        yvert += dy;
-        depth += Jumpdepth;
-        posvert = {(int)yvert, (int)xvert};
-        if (posvert.first < 0 || posvert.first >= mpRows ||
-            posvert.second < 0 || posvert.second >= mpCols)
-            return INF;
-        step++;
-    }
-    return depth;
+    // Evenly fanned across [-spread, spread] around the view direction, so spread shots are repeatable
+    rays = std::max(rays, 1);
+    rayAngles.resize(rays);
+    float pa = mainPlayer->GetA();
+    for (int k = 0; k < rays; k++)
+        rayAngles[k] = rays == 1 ? pa : pa - spread + 2.0f * spread * k / (rays - 1);
+    out.resize(rays);
+    HitscanBatch(mainPlayer->GetX(), mainPlayer->GetY(), rayAngles.data(), rays, HITSCAN_RANGE, out.data());
 }
 
-float Physics::RayHor(float angle, float px, float py, float& xhor, float& yhor)
+bool Physics::Sraycast(int index, float SptFov, float maxDepth)
 {
-    int ymap = (int)py;
-    int mpRows = mainMap->GetRow();
-    int mpCols = mainMap->GetCol();
-
-    float sin_a = std::sin(angle);
-    float cos_a = std::cos(angle);
-    float dx, dy, depth, Jumpdepth;
-
-    if (sin_a > 0) { yhor = ymap + 1; dy = 1; }
-    else { yhor = ymap - 0.0001f; dy = -1; }
-
-    depth = (yhor - py) / sin_a;
-    xhor = px + cos_a * depth;
-    dx = cos_a / sin_a * dy;
-    Jumpdepth = dy / sin_a;
+    if (!mainMap || !mainPlayer || !PhySptList) return false;
 
-    std::pair<int, int> poshor = {(int)yhor, (int)xhor};
-    int maxSteps = mpRows * mpCols * 2;
-    int step = 0;
+    uint8_t visible;
+    sightGrid.CheckSight(&PhySptList->posX[index], &PhySptList->posY[index], &PhySptList->angle[index], 1,
+                         mainPlayer->GetX(), mainPlayer->GetY(), SptFov, maxDepth, &visible);
+    return visible;
+}
 
-    while (!mainMap->FindPos(poshor) && step < maxSteps)
+void Physics::SraycastAll(float SptFov, float maxDepth, std::vector<uint8_t>& out)
+{
+    out.assign(PhySptList ? PhySptList->Size() : 0, 0);
+    if (!mainMap || !mainPlayer || out.empty()) return;
+
+    // Sprites whose cell cannot see the player's cell are settled here, the rest go through the exact batch
+    const Sprites& spt = *PhySptList;
+    const PvsTable& pvs = mainMap->GetPvs();
+    float px = mainPlayer->GetX(), py = mainPlayer->GetY();
+    int playerFloor = pvs.GetFloorIndex(px, py);
+    sightIdx.clear(), sightX.clear(), sightY.clear(), sightA.clear();
+    for (int i = 0; i < spt.Size(); i++)
     {
-        xhor += dx;
-        yhor += dy;
-        depth += Jumpdepth;
-        poshor = {(int)yhor, (int)xhor};
-        if (poshor.first < 0 || poshor.first >= mpRows ||
-            poshor.second < 0 || poshor.second >= mpCols)
-            return INF;
-        step++;
+        if (!pvs.CanSee(pvs.GetFloorIndex(spt.posX[i], spt.posY[i]), playerFloor)) continue;
+        sightIdx.push_back(i);
+        sightX.push_back(spt.posX[i]);
+        sightY.push_back(spt.posY[i]);
+        sightA.push_back(spt.angle[i]);
     }
-    return depth;
+    sightOut.resize(sightIdx.size());
+    sightGrid.CheckSight(sightX.data(), sightY.data(), sightA.data(), (int)sightIdx.size(),
+                         px, py, SptFov, maxDepth, sightOut.data());
+    for (size_t k = 0; k < sightIdx.size(); k++) out[sightIdx[k]] = sightOut[k];
 }
@@ -4,13 +4,23 @@
 bool Player::Init(std::pair<float, float> pos, float a, float s, float hp)
 {
     Px = pos.first, Py = pos.second, Pangle = a, Pspeed = s, Php = hp;
+    SavePose();
     return true;
 }
 
 void Player::ChangePos(std::pair<float, float> pos) {Px = pos.first, Py = pos.second;}
 
-void Player::Rotate(float deltaAngle)
+void Player::SavePose() {prevX = Px, prevY = Py, prevAngle = Pangle;}
+
+float Player::GetPrevX() const {return prevX;}
+
+float Player::GetPrevY() const {return prevY;}
+
+float Player::GetPrevA() const {return prevAngle;}
+
+void Player::Rotate(float deltaAngle, bool blend)
 {
+    if (!blend) prevAngle += deltaAngle;
     Pangle += deltaAngle;
     Pangle = std::fmod(Pangle, 2 * PI);
     if(Pangle < 0) Pangle += 2 * PI;
@@ -0,0 +1,153 @@
+#include "Profiler.h"
+#include "TextRenderer.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+Profiler::Profiler()
+{
+    msPerTick = 1000.0f / (float)SDL_GetPerformanceFrequency();
+}
+
+Profiler& Profiler::Instance()
+{
+    static Profiler profiler;
+    return profiler;
+}
+
+int Profiler::Register(const char* name)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    for (size_t i = 0; i < stages.size(); i++)
+        if (stages[i].name == name) return (int)i;
+
+    Stage stage;
+    stage.name = name;
+    stage.history.assign(historySize, 0.0f);
+    stages.push_back(stage);
+    return (int)stages.size() - 1;
+}
+
+void Profiler::AddTime(int id, Uint64 ticks)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    stages[id].frameMs += ticks * msPerTick;
+}
+
+void Profiler::EndFrame()
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    for (auto& stage : stages)
+    {
+        stage.history[stage.head] = stage.frameMs;
+        stage.head = (stage.head + 1) % historySize;
+        stage.count = std::min(stage.count + 1, historySize);
+        stage.frameMs = 0.0f;
+    }
+}
+
+void Profiler::SetHistorySize(int frames)
+{
+    historySize = std::max(frames, 1);
+    for (auto& stage : stages)
+    {
+        stage.history.assign(historySize, 0.0f);
+        stage.head = 0;
+        stage.count = 0;
+        stage.frameMs = 0.0f;
+    }
+}
+
+ProfileStats Profiler::GetStats(int id) const
+{
+    ProfileStats st = {0, 0, 0, 0};
+    const Stage& stage = stages[id];
+    if (stage.count == 0) return st;
+
+    std::vector<float> samples(stage.history.begin(), stage.history.begin() + stage.count);
+    float sum = 0;
+    for (float v : samples) sum += v;
+    auto minmax = std::minmax_element(samples.begin(), samples.end());
+    st.minMs = *minmax.first;
+    st.maxMs = *minmax.second;
+    st.avgMs = sum / samples.size();
+
+    size_t p99 = (samples.size() * 99) / 100;
+    if (p99 >= samples.size()) p99 = samples.size() - 1;
+    std::nth_element(samples.begin(), samples.begin() + p99, samples.end());
+    st.p99Ms = samples[p99];
+    return st;
+}
+
+int Profiler::GetStageCount() const {return (int)stages.size();}
+
+const std::string& Profiler::GetStageName(int id) const {return stages[id].name;}
+
+void Profiler::ToggleOverlay() {overlay = !overlay;}
+
+bool Profiler::IsOverlayOn() const {return overlay;}
+
+void Profiler::RenderOverlay(SDL_Renderer* renderer, int x, int y, TextRenderer* labels)
+{
+    if (!overlay || !renderer) return;
+    std::lock_guard<std::mutex> lock(mtx);
+
+    // One row per stage: avg bar, p99 tick, 1px = 0.05ms so 16.6ms is ~330px
+    const float pxPerMs = 20.0f;
+    const int rowH = labels ? std::max(8, labels->GetLineHeight()) : 8;
+    const int barMax = 340;
+    const int labelW = labels ? 150 : 0;
+
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_Rect bg = {x - labelW, y, barMax + 8 + labelW, (int)stages.size() * rowH + 8};
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 160);
+    SDL_RenderFillRect(renderer, &bg);
+
+    for (int i = 0; i < (int)stages.size(); i++)
+    {
+        ProfileStats st = GetStats(i);
+        int rowY = y + 4 + i * rowH;
+
+        SDL_Rect bar = {x + 4, rowY, std::min(barMax, (int)(st.avgMs * pxPerMs)), rowH - 2};
+        if (st.avgMs < 1.0f) SDL_SetRenderDrawColor(renderer, 0, 200, 0, 255);
+        else if (st.avgMs < 4.0f) SDL_SetRenderDrawColor(renderer, 230, 200, 0, 255);
+        else SDL_SetRenderDrawColor(renderer, 230, 40, 40, 255);
+        SDL_RenderFillRect(renderer, &bar);
+
+        int p99X = x + 4 + std::min(barMax, (int)(st.p99Ms * pxPerMs));
+        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+        SDL_RenderDrawLine(renderer, p99X, rowY, p99X, rowY + rowH - 3);
+
+        if (!labels) continue;
+        char avg[16];
+        snprintf(avg, sizeof(avg), "%.2f", st.avgMs);
+        labels->Draw(stages[i].name, x - labelW + 4, rowY, {255, 255, 255, 255});
+        labels->Draw(avg, x - 4, rowY, {200, 200, 200, 255}, TEXT_RIGHT);
+    }
+    if (labels) labels->Flush();
+
+    // 60 FPS budget line
+    int budgetX = x + 4 + (int)(1000.0f / 60.0f * pxPerMs);
+    SDL_SetRenderDrawColor(renderer, 0, 160, 255, 255);
+    SDL_RenderDrawLine(renderer, budgetX, y, budgetX, y + bg.h);
+}
+
+bool Profiler::WriteCSV(const std::string& path) const
+{
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "Cannot write profile to " << path << std::endl;
+        return false;
+    }
+
+    out << "stage,min_ms,avg_ms,p99_ms,max_ms,frames\n";
+    for (int i = 0; i < (int)stages.size(); i++)
+    {
+        ProfileStats st = GetStats(i);
+        out << stages[i].name << "," << st.minMs << "," << st.avgMs << ","
+            << st.p99Ms << "," << st.maxMs << "," << stages[i].count << "\n";
+    }
+    std::cout << "Profile written to " << path << std::endl;
+    return true;
+}
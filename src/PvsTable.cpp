@@ -0,0 +1,191 @@
+#include "PvsTable.h"
+#include "Map.h"
+#include "ThreadPool.h"
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+
+#define PVS_SAMPLE 0.25f // samples sit at 0.25 / 0.75 of a cell, so every point is within 0.25 of one
+#define PVS_INSET 0.26f  // blockers pull in a bit further than that to absorb float error
+
+struct Blocker {float x0, x1, y0, y1;};
+
+// Open rectangle against the segment (x0, y0) + t * (dx, dy), t in [0, 1]
+static bool SegmentHits(const Blocker& b, float x0, float y0, float dx, float dy)
+{
+    float t0 = 0.0f, t1 = 1.0f;
+    const float lo[2] = {b.x0 - x0, b.y0 - y0}, hi[2] = {b.x1 - x0, b.y1 - y0}, d[2] = {dx, dy};
+    for (int k = 0; k < 2; k++)
+    {
+        if (d[k] == 0.0f)
+        {
+            if (lo[k] >= 0.0f || hi[k] <= 0.0f) return false;
+            continue;
+        }
+        float ta = lo[k] / d[k], tb = hi[k] / d[k];
+        if (ta > tb) std::swap(ta, tb);
+        t0 = std::max(t0, ta), t1 = std::min(t1, tb);
+    }
+    return t0 < t1;
+}
+
+// Tiles from (x0, y0) to (x1, y1), same walk as SightGrid: |dcol| + |drow| steps,
+// stop when the segment enters the blocker of a wall tile
+static bool SegmentClear(const std::vector<uint8_t>& walls, const std::vector<Blocker>& blockers, int cols,
+                         float x0, float y0, float x1, float y1)
+{
+    float dx = x1 - x0, dy = y1 - y0;
+    int cx = (int)x0, cy = (int)y0;
+    int stepX = dx < 0 ? -1 : 1, stepY = dy < 0 ? -1 : 1;
+    int remX = std::abs((int)x1 - cx), remY = std::abs((int)y1 - cy);
+    float deltaX = 1.0f / std::fmax(std::fabs(dx), 1e-30f);
+    float deltaY = 1.0f / std::fmax(std::fabs(dy), 1e-30f);
+    float sideX = (dx < 0 ? x0 - cx : cx + 1.0f - x0) * deltaX;
+    float sideY = (dy < 0 ? y0 - cy : cy + 1.0f - y0) * deltaY;
+    while (remX + remY > 0)
+    {
+        if (remY == 0 || (remX > 0 && sideX < sideY)) cx += stepX, sideX += deltaX, remX--;
+        else cy += stepY, sideY += deltaY, remY--;
+        if (!walls[cy * cols + cx]) continue;
+        const Blocker* b = &blockers[(cy * cols + cx) * 2];
+        if (SegmentHits(b[0], x0, y0, dx, dy) || SegmentHits(b[1], x0, y0, dx, dy)) return false;
+    }
+    return true;
+}
+
+PvsTable::~PvsTable()
+{
+    cancel = true;
+    if (builder.joinable()) builder.join();
+}
+
+void PvsTable::Build(const Map& map)
+{
+    cancel = true;
+    if (builder.joinable()) builder.join();
+    cancel = false;
+    ready = false;
+    rows = map.GetRow();
+    cols = map.GetCol();
+    std::vector<uint8_t> walls(rows * cols);
+    for (int r = 0; r < rows; r++)
+        for (int c = 0; c < cols; c++) walls[r * cols + c] = map.IsWallUnchecked(r, c);
+    builder = std::thread(&PvsTable::Fill, this, std::move(walls));
+}
+
+void PvsTable::Wait()
+{
+    if (builder.joinable()) builder.join();
+}
+
+// Conservative by construction: a segment the SightGrid walk passes lies on floor tiles. The sample
+// segment with the nearest endpoints stays within PVS_SAMPLE of it along its whole length, so it
+// cannot reach a wall tile's blocker, which is the tile pulled in by PVS_INSET from every side that
+// touches floor (diagonal neighbours included). Sides between walls stay flush, so a solid wall
+// still blocks edge to edge.
+void PvsTable::Fill(std::vector<uint8_t> walls)
+{
+    floorIndex.assign(rows * cols, -1);
+    floorCell.clear();
+    for (int i = 0; i < rows * cols; i++)
+        if (!walls[i]) floorIndex[i] = (int)floorCell.size(), floorCell.push_back(i);
+    floorCount = (int)floorCell.size();
+    const int side = 2 * PVS_RADIUS + 1;
+    stride = (side * side + 31) >> 5;
+
+    // Two rectangles per wall tile; their union is the tile minus the strips and corners near floor
+    auto open = [&](int r, int c) {return r >= 0 && r < rows && c >= 0 && c < cols && !walls[r * cols + c];};
+    auto in = [](bool b) {return b ? PVS_INSET : 0.0f;};
+    std::vector<Blocker> blockers(rows * cols * 2);
+    for (int r = 0; r < rows; r++)
+        for (int c = 0; c < cols; c++)
+        {
+            if (!walls[r * cols + c]) continue;
+            bool L = open(r, c - 1), R = open(r, c + 1), U = open(r - 1, c), D = open(r + 1, c);
+            bool UL = open(r - 1, c - 1), UR = open(r - 1, c + 1), DL = open(r + 1, c - 1), DR = open(r + 1, c + 1);
+            float x = (float)c, y = (float)r;
+            blockers[(r * cols + c) * 2] = {x + in(L), x + 1.0f - in(R), y + in(U || UL || UR), y + 1.0f - in(D || DL || DR)};
+            blockers[(r * cols + c) * 2 + 1] = {x + in(L || UL || DL), x + 1.0f - in(R || UR || DR), y + in(U), y + 1.0f - in(D)};
+        }
+
+    bits.assign(floorCount * stride, 0);
+    auto bit = [&](int dr, int dc) {return (dr + PVS_RADIUS) * side + dc + PVS_RADIUS;};
+    auto set = [&](int a, int k) {bits[a * stride + (k >> 5)] |= 1u << (k & 31);};
+    auto test = [&](int a, int k) {return (bits[a * stride + (k >> 5)] >> (k & 31)) & 1;};
+
+    // Each row tests the later half of its window only, so rows can be filled in parallel
+    const float offs[2] = {PVS_SAMPLE, 1.0f - PVS_SAMPLE};
+    ThreadPool pool;
+    pool.Init(PVS_THREADS, true);
+    pool.ParallelFor(floorCount, [&](int begin, int end) {
+        for (int a = begin; a < end && !cancel; a++)
+        {
+            set(a, bit(0, 0));
+            int ar = floorCell[a] / cols, ac = floorCell[a] % cols;
+            for (int br = ar; br <= std::min(rows - 1, ar + PVS_RADIUS); br++)
+                for (int bc = std::max(0, ac - PVS_RADIUS); bc <= std::min(cols - 1, ac + PVS_RADIUS); bc++)
+                {
+                    if (floorIndex[br * cols + bc] <= a) continue;
+                    bool clear = false;
+                    for (int k = 0; k < 16 && !clear; k++)
+                        clear = SegmentClear(walls, blockers, cols, ac + offs[k & 1], ar + offs[k >> 1 & 1],
+                                             bc + offs[k >> 2 & 1], br + offs[k >> 3]);
+                    if (clear) set(a, bit(br - ar, bc - ac));
+                }
+        }
+    });
+    pool.CleanUp();
+    if (cancel) return;
+
+    // Mirror into the earlier halves so CanSee(a, b) == CanSee(b, a)
+    for (int a = 0; a < floorCount; a++)
+    {
+        int ar = floorCell[a] / cols, ac = floorCell[a] % cols;
+        for (int br = ar; br <= std::min(rows - 1, ar + PVS_RADIUS); br++)
+            for (int bc = std::max(0, ac - PVS_RADIUS); bc <= std::min(cols - 1, ac + PVS_RADIUS); bc++)
+            {
+                int b = floorIndex[br * cols + bc];
+                if (b > a && test(a, bit(br - ar, bc - ac))) set(b, bit(ar - br, ac - bc));
+            }
+    }
+    ready = true;
+}
+
+bool PvsTable::IsReady() const {return ready;}
+
+int PvsTable::GetFloorIndex(float x, float y) const
+{
+    if (!ready || x < 0 || y < 0) return -1;
+    int c = (int)x, r = (int)y;
+    if (r >= rows || c >= cols) return -1;
+    return floorIndex[r * cols + c];
+}
+
+bool PvsTable::CanSee(int fromFloor, int toFloor) const
+{
+    if (fromFloor < 0 || toFloor < 0) return true;
+    int dr = floorCell[toFloor] / cols - floorCell[fromFloor] / cols;
+    int dc = floorCell[toFloor] % cols - floorCell[fromFloor] % cols;
+    if (std::abs(dr) > PVS_RADIUS || std::abs(dc) > PVS_RADIUS) return true;
+    int k = (dr + PVS_RADIUS) * (2 * PVS_RADIUS + 1) + dc + PVS_RADIUS;
+    return (bits[fromFloor * stride + (k >> 5)] >> (k & 31)) & 1;
+}
+
+bool PvsTable::CanSee(float ax, float ay, float bx, float by) const
+{
+    return CanSee(GetFloorIndex(ax, ay), GetFloorIndex(bx, by));
+}
+
+int PvsTable::CountVisible(int fromFloor) const
+{
+    if (!ready) return 0;
+    int cnt = 0;
+    for (int w = 0; w < stride; w++)
+    {
+        uint32_t v = bits[fromFloor * stride + w];
+        while (v) v &= v - 1, cnt++;
+    }
+    return cnt;
+}
+
+int PvsTable::GetFloorCount() const {return ready ? floorCount : 0;}
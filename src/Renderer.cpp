@@ -24,8 +24,21 @@ bool Renderer::OpenWindow(const char* title, int w, int h, bool fullscreen, bool
     window = SDL_CreateWindow(title, SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, w, h, flag);
     if(window == NULL) std::cout << "Window failed to init. Error: " << SDL_GetError() << std::endl;
     renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+    if(renderer == NULL) renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE); // dummy video driver
+    if(renderer == NULL) {
+        std::cout << "Renderer failed to init. Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-    depthBuffer.resize(w);
+
+    // Sized for the full window; smaller render scales use its top-left corner
+    frameTex = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, w, h);
+    SDL_SetTextureBlendMode(frameTex, SDL_BLENDMODE_BLEND);
+    workers.Init();
+    hudText.Init(renderer, FONT_PATH, 32);
+    labelText.Init(renderer, FONT_PATH, 12);
+    viewW = 0, viewH = 0;
+    SetRenderScale(1.0f);
 
     return true;
 }
@@ -34,7 +47,14 @@ void Renderer::CleanUp()
 {
     for (size_t i = 0; i < textures.size(); i++) SDL_DestroyTexture(textures[i]);
     textures.clear();
-
+    atlas.Clear();
+    workers.CleanUp();
+
+    hudText.CleanUp();
+    labelText.CleanUp();
+    SDL_DestroyTexture(frameTex);
+    if (minimapTex) SDL_DestroyTexture(minimapTex);
+    minimapTex = nullptr;
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     std::cout << "Renderer Cleaned Up!" << std::endl;
@@ -44,14 +64,12 @@ void Renderer::CleanUp()
 
 void Renderer::ImportMap(Map& mpp) {mainMap = &mpp;}
 
-void Renderer::ImportPlayer(Player& player) {mainPlayer = &player;}
-
-void Renderer::ImportSprites(std::vector<Sprites>& spt) {SpritesList = &spt;}
-
 void Renderer::ImportInterface(Interface& itf) {itf.GetRenderInfo(renderer, width, height);}
 
 // ========== BASIC RENDER CONTROL ==========
 
+void Renderer::SetSnapshot(const WorldSnapshot& snapshot) {view = &snapshot;}
+
 void Renderer::Clear()
 {
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
@@ -60,139 +78,188 @@ void Renderer::Clear()
 
 void Renderer::Display() {SDL_RenderPresent(renderer); }
 
+void Renderer::UploadFrame()
+{
+    // Stretched over the whole window, this is where a reduced render scale is upscaled
+    SDL_Rect src = {0, 0, viewW, viewH};
+    SDL_UpdateTexture(frameTex, &src, frameBuffer.data(), viewW * sizeof(Uint32));
+    SDL_RenderCopy(renderer, frameTex, &src, NULL);
+}
+
+void Renderer::SetRenderScale(float scale)
+{
+    int w = std::clamp((int)(width * scale), 1, width);
+    int h = std::clamp((int)(height * scale), 1, height);
+    if (w == viewW && h == viewH) return;
+    viewW = w, viewH = h;
+    frameBuffer.assign(w * h, 0);
+    depthBuffer.assign(w, INF);
+    cameraX.resize(w);
+    for (int i = 0; i < w; i++) cameraX[i] = 2.0f * (i + 0.5f) / w - 1.0f;
+}
+
+float Renderer::GetRenderScale() const {return (float)viewW / (float)width;}
+
 // ========== RENDER UI ==========
 
 void Renderer::RenderEnd(int Score, int maxScore)
 {
     if (!renderer) return;
 
-    TTF_Init();
-    TTF_Font* font = TTF_OpenFont("res/font/arial.ttf", 32);
-    if (!font) {
-        std::cerr << "Failed to load font: " << TTF_GetError() << std::endl;
-        return;
-    }
-
     SDL_Color white = {255, 255, 255, 255};
     SDL_Color yellow = {255, 255, 0, 255};
-
-    std::string message = "Game Over";
-    SDL_Surface* surfaceMessage = TTF_RenderText_Solid(font, message.c_str(), yellow);
-    SDL_Texture* textureMessage = SDL_CreateTextureFromSurface(renderer, surfaceMessage);
-    SDL_Rect messageRect = { width / 2 - surfaceMessage->w / 2, height / 2 - 100, surfaceMessage->w, surfaceMessage->h };
-    SDL_RenderCopy(renderer, textureMessage, NULL, &messageRect);
-    SDL_FreeSurface(surfaceMessage);
-    SDL_DestroyTexture(textureMessage);
-
-    std::string scoreText = "Score: " + std::to_string(Score);
-    surfaceMessage = TTF_RenderText_Solid(font, scoreText.c_str(), white);
-    textureMessage = SDL_CreateTextureFromSurface(renderer, surfaceMessage);
-    SDL_Rect scoreRect = { width / 2 - surfaceMessage->w / 2, height / 2, surfaceMessage->w, surfaceMessage->h };
-    SDL_RenderCopy(renderer, textureMessage, NULL, &scoreRect);
-    SDL_FreeSurface(surfaceMessage);
-    SDL_DestroyTexture(textureMessage);
-
-    std::string maxScoreText = "Max Score: " + std::to_string(maxScore);
-    surfaceMessage = TTF_RenderText_Solid(font, maxScoreText.c_str(), white);
-    textureMessage = SDL_CreateTextureFromSurface(renderer, surfaceMessage);
-    SDL_Rect maxScoreRect = { width / 2 - surfaceMessage->w / 2, height / 2 + 50, surfaceMessage->w, surfaceMessage->h };
-    SDL_RenderCopy(renderer, textureMessage, NULL, &maxScoreRect);
-    SDL_FreeSurface(surfaceMessage);
-    SDL_DestroyTexture(textureMessage);
-
-    TTF_CloseFont(font);
-    TTF_Quit();
+    hudText.Draw("Game Over", width / 2, height / 2 - 100, yellow, TEXT_CENTER);
+    hudText.Draw("Score: " + std::to_string(Score), width / 2, height / 2, white, TEXT_CENTER);
+    hudText.Draw("Max Score: " + std::to_string(maxScore), width / 2, height / 2 + 50, white, TEXT_CENTER);
+    hudText.Flush();
 
     SDL_RenderPresent(renderer);
 }
 
-void Renderer::Render2DSprites(float scale)
+void Renderer::RenderHud(float fps, int round, int score)
 {
-    if (!renderer || !SpritesList) return;
-    if (SpritesList->empty()) return;
+    if (!renderer) return;
+    Uint32 now = SDL_GetTicks();
+    if (now - hudFpsTime >= 250) hudFps = (int)(fps + 0.5f), hudFpsTime = now;
 
+    SDL_Color white = {255, 255, 255, 255};
+    int line = hudText.GetLineHeight();
+    hudText.Draw("Round " + std::to_string(round), 12, height - 2 * line - 8, white);
+    hudText.Draw("Score " + std::to_string(score), 12, height - line - 8, white);
+    hudText.Flush();
+    labelText.Draw("FPS " + std::to_string(hudFps), 12, height - 2 * line - labelText.GetLineHeight() - 8, {0, 255, 0, 255});
+    labelText.Flush();
+}
 
-    for (const auto& s : *SpritesList)
-    {
-        int sx = static_cast<int>(s.GetX() * scale);
-        int sy = static_cast<int>(s.GetY() * scale);
-
-        SDL_SetRenderDrawColor(renderer, 0, 0, 255, 255);
-        if(s.IsDead()) SDL_SetRenderDrawColor(renderer, 255, 140, 0, 255);
-        SDL_Rect spriteRect;
-        spriteRect.x = sx - 2;
-        spriteRect.y = sy - 2;
-        spriteRect.w = 4;
-        spriteRect.h = 4;
-        SDL_RenderFillRect(renderer, &spriteRect);
-
-
-        float a = s.GetA();
-        int len = 6;
-        int lx = static_cast<int>(sx + len * std::cos(a));
-        int ly = static_cast<int>(sy + len * std::sin(a));
-
-        SDL_SetRenderDrawColor(renderer, 0, 128, 255, 255);
-        SDL_RenderDrawLine(renderer, sx, sy, lx, ly);
-    }
+void Renderer::RenderLoading(float progress)
+{
+    if (!renderer) return;
+    Clear();
+    SDL_Rect frame = {width / 4, height / 2, width / 2, 16};
+    SDL_Rect bar = {frame.x + 2, frame.y + 2, (int)((frame.w - 4) * std::clamp(progress, 0.0f, 1.0f)), frame.h - 4};
+    SDL_SetRenderDrawColor(renderer, 192, 192, 192, 255);
+    SDL_RenderDrawRect(renderer, &frame);
+    SDL_SetRenderDrawColor(renderer, 255, 140, 0, 255);
+    SDL_RenderFillRect(renderer, &bar);
+    hudText.Draw("Loading " + std::to_string((int)(progress * 100.0f)) + "%", width / 2, frame.y - hudText.GetLineHeight() - 8,
+                 {255, 255, 255, 255}, TEXT_CENTER);
+    hudText.Flush();
+    SDL_RenderPresent(renderer);
 }
 
+void Renderer::RenderProfilerOverlay() {Profiler::Instance().RenderOverlay(renderer, width - 356, 8, &labelText);}
 
-void Renderer::Render2DMap(float scale)
+bool Renderer::BakeMinimap(int tile)
 {
-    SDL_Rect bg;
-    bg.x = 0, bg.y = 0, bg.w = mainMap->GetCol()*scale, bg.h = mainMap->GetRow()*scale;
-    SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
-    SDL_RenderFillRect(renderer, &bg);
-    std::map<std::pair<int, int>, int>* MapData = mainMap->GetMap();
-    for (auto it = MapData->begin(); it != MapData->end(); ++it)
-    {
-        int r = it->first.first;
-        int c = it->first.second;
-        int val = it->second;
-
-        if (val)
+    if (minimapTex) SDL_DestroyTexture(minimapTex);
+    minimapTex = nullptr;
+    int rows = mainMap->GetRow(), cols = mainMap->GetCol();
+
+    // Shrink the baked tiles if the map would not fit in one texture, the blit scales them back up
+    SDL_RendererInfo info;
+    int texTile = tile;
+    if (SDL_GetRendererInfo(renderer, &info) == 0 && info.max_texture_width > 0 && info.max_texture_height > 0)
+        texTile = std::max(1, std::min({tile, info.max_texture_width / cols, info.max_texture_height / rows}));
+
+    SDL_Surface* surf = SDL_CreateRGBSurfaceWithFormat(0, cols * texTile, rows * texTile, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (!surf) {
+        std::cerr << "Minimap bake failed: " << SDL_GetError() << "\n";
+        return false;
+    }
+    Uint32 floor = SDL_MapRGB(surf->format, 0, 255, 0);
+    Uint32 edge = SDL_MapRGB(surf->format, 192, 192, 192);
+    Uint32 fill = SDL_MapRGB(surf->format, 128, 128, 128);
+    SDL_FillRect(surf, NULL, floor);
+    for (int r = 0; r < rows; r++)
+        for (int c = 0; c < cols; c++)
         {
-            SDL_Rect rect;
-            rect.x = c * scale;
-            rect.y = r * scale;
-            rect.w = scale;
-            rect.h = scale;
-            SDL_SetRenderDrawColor(renderer, 128, 128, 128, 255);
-            SDL_RenderFillRect(renderer, &rect);
-            SDL_SetRenderDrawColor(renderer, 192, 192, 192, 255);
-            SDL_RenderDrawRect(renderer, &rect);
+            if (!mainMap->IsWallUnchecked(r, c)) continue;
+            SDL_Rect rect = {c * texTile, r * texTile, texTile, texTile};
+            SDL_FillRect(surf, &rect, edge);
+            if (texTile < 3) continue;
+            rect = {rect.x + 1, rect.y + 1, texTile - 2, texTile - 2};
+            SDL_FillRect(surf, &rect, fill);
         }
+    minimapTex = SDL_CreateTextureFromSurface(renderer, surf);
+    SDL_FreeSurface(surf);
+    if (!minimapTex) {
+        std::cerr << "Minimap bake failed: " << SDL_GetError() << "\n";
+        return false;
     }
+    minimapVersion = mainMap->GetVersion();
+    minimapTile = tile, minimapTexTile = texTile;
+    return true;
+}
+
+void Renderer::Render2DMap(float scale)
+{
+    if (!renderer || !view || !mainMap) return;
+    int tile = std::max(1, (int)scale);
+    if (!minimapTex || minimapVersion != mainMap->GetVersion() || minimapTile != tile)
+        if (!BakeMinimap(tile)) return;
+
+    int mapW = mainMap->GetCol() * tile, mapH = mainMap->GetRow() * tile;
+    minimapView.w = std::min(mapW, MINIMAP_MAX_W);
+    minimapView.h = std::min(mapH, MINIMAP_MAX_H);
+    minimapView.x = std::clamp((int)(view->LerpPlayerX() * tile) - minimapView.w / 2, 0, mapW - minimapView.w);
+    minimapView.y = std::clamp((int)(view->LerpPlayerY() * tile) - minimapView.h / 2, 0, mapH - minimapView.h);
+
+    SDL_Rect src = {minimapView.x * minimapTexTile / tile, minimapView.y * minimapTexTile / tile,
+                    minimapView.w * minimapTexTile / tile, minimapView.h * minimapTexTile / tile};
+    SDL_Rect dst = {0, 0, minimapView.w, minimapView.h};
+    SDL_RenderCopy(renderer, minimapTex, &src, &dst);
 }
 
-void Renderer::Render2DPlayer(float scale)
+void Renderer::AddMarkerQuad(float x0, float y0, float x1, float y1, float halfW, SDL_Color c)
 {
-    if(!renderer) return;
-
-    float x = mainPlayer->GetX();
-    float y = mainPlayer->GetY();
-    float angle = mainPlayer->GetA();
-    int px = static_cast<int>(x * scale);
-    int py = static_cast<int>(y * scale);
-
-    SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
-    SDL_Rect srcRect;
-    srcRect.x = px - 2;
-    srcRect.y = py - 2;
-    srcRect.w = 5;
-    srcRect.h = 5;
-    SDL_RenderFillRect(renderer, &srcRect);
-
-    int lineLength = 10;
-    int lx = static_cast<int>(px + lineLength * cos(angle));
-    int ly = static_cast<int>(py + lineLength * sin(angle));
-    SDL_RenderDrawLine(renderer, px, py, lx, ly);
+    // Segment from (x0, y0) to (x1, y1) widened by halfW each side; a zero-length one is a square
+    float dx = x1 - x0, dy = y1 - y0;
+    float len = std::sqrt(dx * dx + dy * dy);
+    float ex = halfW, ey = 0.0f, nx = 0.0f, ny = -halfW; // along / across the segment
+    if (len > 1e-4f) ex = ey = 0.0f, nx = -dy / len * halfW, ny = dx / len * halfW;
+    int base = (int)markerVerts.size();
+    markerVerts.push_back({{x0 - ex + nx, y0 - ey + ny}, c, {0, 0}});
+    markerVerts.push_back({{x1 + ex + nx, y1 + ey + ny}, c, {0, 0}});
+    markerVerts.push_back({{x1 + ex - nx, y1 + ey - ny}, c, {0, 0}});
+    markerVerts.push_back({{x0 - ex - nx, y0 - ey - ny}, c, {0, 0}});
+    const int quad[6] = {0, 1, 2, 0, 2, 3};
+    for (int k : quad) markerIdx.push_back(base + k);
+}
+
+void Renderer::Render2DMarkers(float scale)
+{
+    if (!renderer || !view || minimapView.w <= 0) return;
+    int tile = std::max(1, (int)scale);
+    float ox = (float)minimapView.x, oy = (float)minimapView.y;
+    markerVerts.clear();
+    markerIdx.clear();
+
+    for (const auto& s : view->sprites)
+    {
+        float sx = view->LerpX(s) * tile - ox, sy = view->LerpY(s) * tile - oy;
+        if (sx < -8 || sy < -8 || sx > minimapView.w + 8 || sy > minimapView.h + 8) continue;
+        SDL_Color body = s.dead ? SDL_Color{255, 140, 0, 255} : SDL_Color{0, 0, 255, 255};
+        AddMarkerQuad(sx, sy, sx, sy, 2.0f, body);
+        float a = view->LerpAngle(s);
+        AddMarkerQuad(sx, sy, sx + 6 * FastMath::Cos(a), sy + 6 * FastMath::Sin(a), 0.5f, {0, 128, 255, 255});
+    }
+
+    float px = view->LerpPlayerX() * tile - ox, py = view->LerpPlayerY() * tile - oy;
+    float angle = view->LerpPlayerAngle();
+    SDL_Color red = {255, 0, 0, 255};
+    AddMarkerQuad(px, py, px, py, 2.5f, red);
+    AddMarkerQuad(px, py, px + 10 * FastMath::Cos(angle), py + 10 * FastMath::Sin(angle), 0.5f, red);
+
+    SDL_Rect clip = {0, 0, minimapView.w, minimapView.h};
+    SDL_RenderSetClipRect(renderer, &clip);
+    SDL_RenderGeometry(renderer, NULL, markerVerts.data(), (int)markerVerts.size(), markerIdx.data(), (int)markerIdx.size());
+    SDL_RenderSetClipRect(renderer, NULL);
 }
 
 void Renderer::RenderBackGround()
 {
-    float pitch = mainPlayer->GetPitch();
+    if (!view) return;
+    float pitch = view->playerPitch;
 
 
     int horizon = height / 2 + static_cast<int>(pitch * height);
@@ -224,337 +291,231 @@ void Renderer::RenderBackGround()
 
 // ========== RAYCASTING CORE ==========
 
-float Renderer::RayVert(float angle, float px, float py, float& xvert, float& yvert)
+void Renderer::DrawColByColor(int i, float distanceCorrected)
 {
-    int xmap = (int)px;
-    int mpRows = mainMap->GetRow(), mpCols = mainMap->GetCol();
-
-    float sin_a = std::sin(angle);
-    float cos_a = std::cos(angle);
-    float dx, dy, depth, Jumpdepth;
+    float playerPitch = view->playerPitch;
+    int lineHeight = (int)(viewH / distanceCorrected);
+    if(lineHeight > viewH) lineHeight = viewH;
 
-    if(cos_a > 0) { xvert = xmap + 1; dx = 1; }
-    else          { xvert = xmap - 0.00001f; dx = -1; }
+    int pitchOffset = (int)(playerPitch * viewH);
+    int drawStart = viewH / 2 - lineHeight / 2 + pitchOffset;
+    int drawEnd   = viewH / 2 + lineHeight / 2 + pitchOffset;
 
-    depth = (xvert - px) / cos_a;
-    yvert = py + sin_a * depth;
-    dy = sin_a / cos_a * dx;
-    Jumpdepth = dx / cos_a;
-
-    std::pair<int,int> posvert = {(int)yvert, (int)xvert};
-    int maxSteps = mpRows * mpCols * 2;
-    int step = 0;
-
-    while(!mainMap->FindPos(posvert) && step < maxSteps)
-    {
-        xvert += dx;
-        yvert += dy;
-        depth += Jumpdepth;
-        posvert = {(int)yvert, (int)xvert};
-        if(posvert.first < 0 || posvert.first >= mpRows || posvert.second < 0 || posvert.second >= mpCols)
-            return INF;
-        step++;
-    }
+    if(drawStart < 0) drawStart = 0;
+    if(drawEnd >= viewH) drawEnd = viewH - 1;
 
-    return depth;
+    Uint32 color = std::min(255, (int)(255 / (1 + distanceCorrected * 0.2f)));
+    Uint32 argb = 0xFF000000 | (color << 16) | (color << 8) | color;
+    for (int y = drawStart; y <= drawEnd; y++) frameBuffer[y * viewW + i] = argb;
 }
 
-float Renderer::RayHor(float angle, float px, float py, float& xhor, float& yhor)
+void Renderer::DrawColByTex(int i, const RayHit& hit)
 {
-    int ymap = (int)py;
-    int mpRows = mainMap->GetRow(), mpCols = mainMap->GetCol();
-
-    float sin_a = std::sin(angle);
-    float cos_a = std::cos(angle);
-    float dx, dy, depth, Jumpdepth;
+    float playerPitch = view->playerPitch;
+    float distance = std::max(hit.distance, 0.001f);
+    int lineHeight = (int)((viewH) / distance);
+    if (lineHeight < 1) lineHeight = 1;
 
-    if(sin_a > 0) { yhor = ymap + 1; dy = 1; }
-    else           { yhor = ymap - 0.0001f; dy = -1; }
+    int pitchOffset = (int)(playerPitch * viewH);
+    int drawStart = viewH / 2 - lineHeight / 2 + pitchOffset;
+    int drawEnd   = viewH / 2 + lineHeight / 2 + pitchOffset;
 
-    depth = (yhor - py) / sin_a;
-    xhor = px + cos_a * depth;
-    dx = cos_a / sin_a * dy;
-    Jumpdepth = dy / sin_a;
+    int texIndex = hit.tex;
+    if (texIndex < 0 || texIndex >= atlas.Size()) return;
 
-    std::pair<int,int> poshor = {(int)yhor, (int)xhor};
-    int maxSteps = mpRows * mpCols * 2;
-    int step = 0;
+    const AtlasEntry& tex = atlas.Get(texIndex);
+    int texW = tex.w, texH = tex.h;
+    int texX = (int)(hit.wallX * texW);
+    if (texX < 0) texX = 0;
+    if (texX >= texW) texX = texW - 1;
 
-    while(!mainMap->FindPos(poshor) && step < maxSteps)
+    int yStart = std::max(drawStart, 0);
+    int yEnd = std::min(drawEnd, viewH - 1);
+    const Uint32* column = atlas.Column(texIndex, texX);
+    for (int y = yStart; y <= yEnd; y++)
     {
-        xhor += dx;
-        yhor += dy;
-        depth += Jumpdepth;
-        poshor = {(int)yhor, (int)xhor};
-        if(poshor.first < 0 || poshor.first >= mpRows || poshor.second < 0 || poshor.second >= mpCols)
-            return INF;
-        step++;
+        int texY = (y - drawStart) * texH / lineHeight;
+        if (texY >= texH) texY = texH - 1;
+        frameBuffer[y * viewW + i] = column[texY];
     }
-
-    return depth;
-}
-
-void Renderer::DrawColByColor(int i, int height, float distanceCorrected)
-{
-    float playerPitch = mainPlayer->GetPitch();
-    int lineHeight = (int)(height / distanceCorrected);
-    if(lineHeight > height) lineHeight = height;
-
-    int pitchOffset = (int)(playerPitch * height);
-    int drawStart = height / 2 - lineHeight / 2 + pitchOffset;
-    int drawEnd   = height / 2 + lineHeight / 2 + pitchOffset;
-
-    if(drawStart < 0) drawStart = 0;
-    if(drawEnd >= height) drawEnd = height - 1;
-
-    int color = std::min(255, (int)(255 / (1 + distanceCorrected * 0.2f)));
-    SDL_SetRenderDrawColor(renderer, color, color, color, 255);
-    SDL_RenderDrawLine(renderer, i, drawStart, i, drawEnd);
 }
 
-void Renderer::DrawColByTex(int i, int height, float distanceCorrected, float xwall, float ywall, bool walltype)
+void Renderer::RayCasting()
 {
-    float playerPitch = mainPlayer->GetPitch();
-    int lineHeight = (int)((height) / distanceCorrected);
-    if (lineHeight < 1) lineHeight = 1;
-
-    int pitchOffset = (int)(playerPitch * height);
-    int drawStart = height / 2 - lineHeight / 2 + pitchOffset;
-    int drawEnd   = height / 2 + lineHeight / 2 + pitchOffset;
-
-    int mx, my;
-    if (walltype) {
-        mx = (int)xwall;
-        if (xwall - mx < 1e-4f) mx--;
-        my = (int)ywall;
-    } else {
-        my = (int)ywall;
-        if (ywall - my < 1e-4f) my--;
-        mx = (int)xwall;
-    }
-
-    int texIndex = -1;
-    if (mainMap->FindPos({my, mx})) texIndex = mainMap->GetVal({my, mx});
-    else
+    if (!view) return;
+    float px = view->LerpPlayerX(), py = view->LerpPlayerY();
+    float angle = view->LerpPlayerAngle();
+    float planeLen = std::tan(FOV_ANGLE / 2);
+    float dirX = std::cos(angle), dirY = std::sin(angle);
+    float planeX = -dirY * planeLen, planeY = dirX * planeLen;
+
+    std::fill(frameBuffer.begin(), frameBuffer.end(), 0);
+    workers.ParallelFor(viewW, [&](int begin, int end)
     {
-        int tryOffsets[4][2] = {
-            {0, 1},
-            {0, -1},
-            {1, 0},
-            {-1, 0}
-        };
-        for (int k = 0; k < 4; k++)
+        for(int i = begin; i < end; i++)
         {
-            int nx = mx + tryOffsets[k][1];
-            int ny = my + tryOffsets[k][0];
-            if (mainMap->FindPos({ny, nx}))
+            float rayX = dirX + planeX * cameraX[i];
+            float rayY = dirY + planeY * cameraX[i];
+            RayHit hit;
+            if(!mainMap->CastRay(px, py, rayX, rayY, hit))
             {
-                texIndex = mainMap->GetVal({ny, nx});
-                break;
+                depthBuffer[i] = INF;
+                continue;
             }
+            depthBuffer[i] = hit.distance;
+            //DrawColByColor(i, hit.distance);
+            DrawColByTex(i, hit);
         }
-        if (texIndex == -1) return;
-    }
-
-    if (texIndex < 0 || texIndex >= (int)textures.size()) return;
-
-    SDL_Texture* tex = textures[texIndex];
-    int texW, texH;
-    SDL_QueryTexture(tex, NULL, NULL, &texW, &texH);
-    float wallX = walltype ? ywall - floor(ywall) : xwall - floor(xwall);
-    if (wallX < 0) wallX += 1.0f;
-    if (wallX >= 1.0f) wallX = 0.999f;
-
-    int texX = (int)(wallX * texW);
-    if (texX < 0) texX = 0;
-    if (texX >= texW) texX = texW - 1;
+    });
+}
 
-    int srcY = 0;
-    int srcH = texH;
-    int dstY = drawStart;
-    int dstH = drawEnd - drawStart + 1;
+// ========== RENDER SPRITES =========
 
-    if (drawStart < 0) {
-        srcY = (-drawStart * texH) / lineHeight;
-        srcH -= srcY;
-        dstY = 0;
-        dstH = drawEnd + 1;
-    }
-    if (drawEnd >= height) {
-        int cut = (drawEnd - height + 1) * texH / lineHeight;
-        srcH -= cut;
-        dstH = height - dstY;
+void Renderer::BuildDrawList()
+{
+    drawList.clear();
+    float px = view->LerpPlayerX();
+    float py = view->LerpPlayerY();
+    float dirX = std::cos(view->LerpPlayerAngle());
+    float dirY = std::sin(view->LerpPlayerAngle());
+    float planeLen = std::tan(FOV_ANGLE / 2.0f);
+    float planeX = -dirY * planeLen, planeY = dirX * planeLen;
+    float invDet = 1.0f / (planeX * dirY - dirX * planeY); // inverse of the [plane dir] camera matrix
+
+    for (size_t i = 0; i < view->sprites.size(); i++)
+    {
+        const auto& sp = view->sprites[i];
+        if (!sp.visible) continue;
+
+        int texIndex = sp.texIndex;
+        if (texIndex < 0 || texIndex >= atlas.Size()) continue;
+
+        float spX = view->LerpX(sp), spY = view->LerpY(sp);
+        float dx = spX - px;
+        float dy = spY - py;
+        float transformX = invDet * (dirY * dx - dirX * dy);
+        float depth = invDet * (-planeY * dx + planeX * dy);
+        if (depth <= SPRITE_NEAR) continue;
+        int screenX = static_cast<int>((viewW / 2.0f) * (1.0f + transformX / depth));
+
+        int frame = sp.state < 2 ? Sprites::DirIndex(spX, spY, view->LerpAngle(sp), px, py, 8) : sp.aniCnt - 1;
+        const SDL_Rect& frameRect = atlas.GetFrame(texIndex, frame);
+        int spriteH = int(viewH / depth);
+        int spriteW = int(spriteH * (float(frameRect.w) / float(atlas.Get(texIndex).h)));
+        if (spriteW <= 0 || spriteH <= 0) continue;
+        if (screenX + spriteW / 2 < 0 || screenX - spriteW / 2 >= viewW) continue;
+
+        float q = std::min(depth * DEPTH_KEY_SCALE, 65535.0f);
+        drawList.push_back({65535u - (uint32_t)q, (int)i, texIndex, frame, depth, screenX, spriteW, spriteH});
     }
-
-    if (srcH <= 0 || dstH <= 0) return;
-
-    SDL_Rect src = { texX, srcY, 1, srcH };
-    SDL_Rect dst = { i, dstY, 1, dstH };
-
-    SDL_RenderCopy(renderer, tex, &src, &dst);
 }
 
-void Renderer::RayCasting()
+void Renderer::SortDrawList()
 {
-    float FOV = PI/3;
-    float Half_FOV = FOV/2;
-    float RayAngle = mainPlayer->GetA() - Half_FOV;
-    float px = mainPlayer->GetX(), py = mainPlayer->GetY();
-    int numRays = width;
-    float DeltaAngle = FOV / numRays;
-
-    for(int i = 0; i < numRays; i++)
+    // Two 8-bit LSD radix passes over the 16-bit key, stable, back to front
+    drawScratch.resize(drawList.size());
+    std::vector<DrawItem>* src = &drawList;
+    std::vector<DrawItem>* dst = &drawScratch;
+    for (int shift = 0; shift < 16; shift += 8)
     {
-        float xvert, yvert, xhor, yhor, xwall, ywall; bool walltype;
-        float d_vert = RayVert(RayAngle, px, py, xvert, yvert);
-        float d_hor  = RayHor(RayAngle, px, py, xhor, yhor);
-        float distance = std::min(d_vert, d_hor);
-        //depthBuffer[i] = distance;
-        if(distance == INF) continue;
-        if(d_vert == distance) xwall = xvert, ywall = yvert, walltype = true;
-        else xwall = xhor, ywall = yhor, walltype = false;
-        float distanceCorrected = distance * cos(RayAngle - mainPlayer->GetA());
-        depthBuffer[i] = distanceCorrected;
-        if(distanceCorrected < 0.001f) distanceCorrected = 0.001f;
-        //DrawColByColor(i, height, distanceCorrected);
-        DrawColByTex(i, height, distanceCorrected, xwall, ywall, walltype);
-        RayAngle += DeltaAngle;
-        if(RayAngle < 0) RayAngle += 2*PI;
-        if(RayAngle > 2*PI) RayAngle -= 2*PI;
+        int count[257] = {0};
+        for (const auto& d : *src) count[((d.key >> shift) & 0xFF) + 1]++;
+        for (int b = 0; b < 256; b++) count[b + 1] += count[b];
+        for (const auto& d : *src) (*dst)[count[(d.key >> shift) & 0xFF]++] = d;
+        std::swap(src, dst);
     }
+    // An even number of passes leaves the result back in drawList
 }
 
-// ========== RENDER SPRITES =========
-
-void Renderer::SortSprites(std::vector<Sprites>* list) {
-    std::sort(list->begin(), list->end(),
-        [this](const Sprites& a, const Sprites& b) {
-            float ax = a.GetX() - mainPlayer->GetX();
-            float ay = a.GetY() - mainPlayer->GetY();
-            float bx = b.GetX() - mainPlayer->GetX();
-            float by = b.GetY() - mainPlayer->GetY();
-
-            float distA = ax * ax + ay * ay;
-            float distB = bx * bx + by * by;
-            return distA > distB;
-        });
+void Renderer::DrawSpriteColumns(const DrawItem& d, int pitchOffset, int begin, int end)
+{
+    const AtlasEntry& tex = atlas.Get(d.texIndex);
+    const SDL_Rect& frameRect = atlas.GetFrame(d.texIndex, d.frame);
+    int drawStartX = d.screenX - d.spriteW / 2;
+    int drawStartY = viewH / 2 - d.spriteH / 2 + pitchOffset;
+    int xStart = std::max(drawStartX, begin);
+    int xEnd = std::min(drawStartX + d.spriteW, end);
+    int yStart = std::max(drawStartY, 0);
+    int yEnd = std::min(drawStartY + d.spriteH, viewH);
+
+    for (int x = xStart; x < xEnd; x++)
+    {
+        if (d.depth >= depthBuffer[x]) continue;
+        int texX = (x - drawStartX) * frameRect.w / d.spriteW;
+        const Uint32* column = atlas.Column(d.texIndex, frameRect.x + texX);
+        for (int y = yStart; y < yEnd; y++)
+        {
+            Uint32 texel = column[(y - drawStartY) * tex.h / d.spriteH];
+            if (!(texel & 0x80000000)) continue; // transparent texel
+            frameBuffer[y * viewW + x] = texel;
+        }
+    }
 }
 
 void Renderer::RenderSprites()
 {
-    if (!SpritesList || !mainPlayer || depthBuffer.empty() || textures.empty()) return;
-    if (depthBuffer.size() < (size_t)width) return;
-    SortSprites(SpritesList);
-    int temp[4];
-    for (size_t i = 0; i < SpritesList->size(); i++)
+    if (view && !depthBuffer.empty() && atlas.Size() > 0 &&
+        depthBuffer.size() >= (size_t)viewW)
     {
-        const auto& sp = (*SpritesList)[i];
-        if(!sp.CheckVisible()) continue;
-        if(sp.name == "cacodemon") temp[0] = 3, temp[1] = 5, temp[2] = 2, temp[3] = 6;
-        if(sp.name == "cyberdemon") temp[0] = 4, temp[1] = 2, temp[2] = 2, temp[3] = 9;
-        int texDir = sp.GetDirIndex(mainPlayer->GetX(), mainPlayer->GetY(), mainPlayer->GetA(), 8);
-
-        int texIndex = sp.GetTexID() + sp.GetState();
-        if (texIndex < 0 || texIndex >= (int)textures.size()) continue;
-
-        SDL_Texture* tex = textures[texIndex];
-        int texW, texH;
-        SDL_QueryTexture(tex, nullptr, nullptr, &texW, &texH);
-
-        float dx = sp.GetX() - mainPlayer->GetX();
-        float dy = sp.GetY() - mainPlayer->GetY();
-        float playerAngle = mainPlayer->GetA();
-
-        float dist = sqrt(dx*dx + dy*dy);
-        float transformY = dist * cos(atan2(dy, dx) - playerAngle);
-        if (transformY <= 0.6) continue;
-
-        float FOV = PI / 3.0f;
-
-        float angleToSprite = atan2(dy, dx);
-        float angleDiff = playerAngle - angleToSprite;
-
-        if (angleDiff > PI) angleDiff -= 2 * PI;
-        if (angleDiff < -PI) angleDiff += 2 * PI;
-
-        int spriteScreenX = static_cast<int>((width / 2.0f) - (angleDiff * (width / FOV)));
-
-        float playerPitch = mainPlayer->GetPitch();
-        int pitchOffset = (int)(playerPitch * height);
-
-        int frameW = texW / 8;
-        if(sp.GetState() == 0) frameW = texW, texDir = 0;
-        if(sp.GetState() == 2) frameW = texW/temp[0];
-        if(sp.GetState() == 3) frameW = texW/temp[1];
-        if(sp.GetState() == 4) frameW = texW/temp[2];
-        if(sp.GetState() == 5) frameW = texW/temp[3];
-
-        int spriteHeight = abs(int(height / transformY));
-        int spriteWidth  = int(spriteHeight * (float(frameW) / float(texH)));
-        int drawStartX = -spriteWidth / 2 + spriteScreenX;
-        int drawEndX   =  spriteWidth / 2 + spriteScreenX;
-        int drawStartY = -spriteHeight / 2 + height / 2 + pitchOffset;
-        int drawEndY = drawStartY + spriteHeight;
-        for (int stripe = drawStartX; stripe < drawEndX; stripe++)
+        BuildDrawList();
+        SortDrawList();
+
+        int pitchOffset = (int)(view->playerPitch * viewH);
+        // Each worker owns a range of columns and draws the whole list back to front inside it
+        workers.ParallelFor(viewW, [&](int begin, int end)
         {
-            if (stripe < 0 || stripe >= width) continue;
-            //if (dist >= depthBuffer[stripe]) continue;
-            if (transformY >= depthBuffer[stripe]) continue;
-            int texX = int((stripe - (-spriteWidth / 2 + spriteScreenX)) * frameW / spriteWidth);
-            SDL_Rect src, dest;
-            if(sp.GetState() < 2)
-            {
-                src  = { texDir * frameW + texX, 0, 1, texH };
-                dest = { stripe, drawStartY, 1, drawEndY - drawStartY };
-            }
-            else
-            {
-                src  = { (sp.GetAniCnt() - 1) * frameW + texX, 0, 1, texH };
-                dest = { stripe, drawStartY, 1, drawEndY - drawStartY };
-            }
-            SDL_RenderCopy(renderer, tex, &src, &dest);
-        }
+            for (const auto& d : drawList) DrawSpriteColumns(d, pitchOffset, begin, end);
+        });
     }
+    // Walls and sprites share the frame buffer, it goes to the screen once both are in
+    UploadFrame();
 }
 
 
 // ========== TEXTURE UTILS ==========
 
-void Renderer::LoadBG() {textures.push_back(IMG_LoadTexture(renderer, "res/bg/sky.png"));}
-
-void Renderer::LoadTextures(const std::string& folder)
+bool Renderer::AddTexture(SDL_Surface* pixels, const std::string& path)
 {
-    int cnt = 0;
-    std::cout << "Renderer Loading... ";
-
-    if (!fs::exists(folder) || !fs::is_directory(folder)) {
-        std::cerr << "Cannot open folder: " << folder << "\n";
-        return;
+    if (!pixels) return false;
+    SDL_Texture* tex = SDL_CreateTextureFromSurface(renderer, pixels);
+    if (!tex) {
+        std::cerr << "Failed to create texture for " << path << ": "
+                  << SDL_GetError() << "\n";
+        SDL_FreeSurface(pixels);
+        return false;
     }
+    textures.push_back(tex);
+    atlas.Add(pixels);
+    SDL_FreeSurface(pixels);
+    return true;
+}
 
-    std::vector<fs::path> files;
-    for (const auto& entry : fs::directory_iterator(folder)) {
-        if (!entry.is_regular_file()) continue;
-        files.push_back(entry.path());
+int Renderer::AddFolder(const std::string& folder, const std::vector<SDL_Surface*>& sheets, const std::vector<int>& frameCounts)
+{
+    auto it = folderCache.find(folder);
+    if (it != folderCache.end()) // already added by an earlier load
+    {
+        for (SDL_Surface* s : sheets) if (s) SDL_FreeSurface(s);
+        return it->second;
     }
-
-    std::sort(files.begin(), files.end());
-
-    for (const auto& path : files) {
-        SDL_Texture* tex = IMG_LoadTexture(renderer, path.string().c_str());
-        if (!tex) {
-            std::cerr << "Failed to load " << path << ": "
-                      << IMG_GetError() << "\n";
-            continue;
-        }
-        textures.push_back(tex);
-        cnt++;
+    // States index from texBase, so a missing sheet fails the whole folder instead of shifting the rest
+    int texBase = GetTexSize(), added = 0;
+    for (SDL_Surface* sheet : sheets) added += AddTexture(sheet, folder);
+    if (added != (int)sheets.size()) {
+        std::cerr << "Failed to load " << folder << ": " << added << " of "
+                  << sheets.size() << " sheets\n";
+        return -1;
     }
-
-    std::cout << "Loaded " << cnt << " textures from " << folder << ".\n";
+    SetSheetFrames(texBase, frameCounts);
+    folderCache.emplace(folder, texBase);
+    return texBase;
 }
 
-
+int Renderer::FindTextures(const std::string& folder) const
+{
+    auto it = folderCache.find(folder);
+    return it == folderCache.end() ? -1 : it->second;
+}
 
 SDL_Texture* Renderer::GetTextureByIndex(int index)
 {
@@ -567,4 +528,15 @@ SDL_Texture* Renderer::GetTextureByIndex(int index)
 
 int Renderer::GetTexSize() {return textures.size();}
 
-void Renderer::ClearTex() {textures.clear();}
+void Renderer::ClearTex()
+{
+    for (size_t i = 0; i < textures.size(); i++) SDL_DestroyTexture(textures[i]);
+    textures.clear();
+    folderCache.clear();
+    atlas.Clear();
+}
+
+void Renderer::SetSheetFrames(int texBase, const std::vector<int>& frameCounts)
+{
+    for (size_t i = 0; i < frameCounts.size(); i++) atlas.SetFrames(texBase + (int)i, frameCounts[i]);
+}
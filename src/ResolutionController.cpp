@@ -0,0 +1,44 @@
+#include "ResolutionController.h"
+#include <algorithm>
+#include <cmath>
+
+void ResolutionController::Enable(float frameBudgetMs)
+{
+    enabled = frameBudgetMs > 0;
+    budgetMs = frameBudgetMs;
+    avgMs = 0.0f;
+    cooldown = 0;
+}
+
+void ResolutionController::Disable(float fixedScale)
+{
+    enabled = false;
+    scale = std::clamp(fixedScale, RES_SCALE_MIN, RES_SCALE_MAX);
+}
+
+bool ResolutionController::IsEnabled() const {return enabled;}
+
+float ResolutionController::Update(float workMs)
+{
+    if (!enabled || workMs <= 0) return scale;
+    avgMs = avgMs <= 0 ? workMs : avgMs + (workMs - avgMs) * 0.1f;
+    if (cooldown > 0) { cooldown--; return scale; }
+
+    float target = budgetMs * RES_HEADROOM;
+    if (avgMs > budgetMs)
+    {
+        scale = std::max(RES_SCALE_MIN, scale * std::sqrt(target / avgMs));
+        avgMs = target; // the average still holds the slow frames, judge the new scale on fresh ones
+        cooldown = 10;
+    }
+    else if (avgMs < target * 0.8f && scale < RES_SCALE_MAX)
+    {
+        scale = std::min(RES_SCALE_MAX, scale + RES_SCALE_STEP);
+        cooldown = 30;
+    }
+    return scale;
+}
+
+float ResolutionController::GetScale() const {return scale;}
+
+float ResolutionController::GetAverageMs() const {return avgMs;}
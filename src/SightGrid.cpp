@@ -0,0 +1,201 @@
+#include "SightGrid.h"
+#include "FastMath.h"
+#include <cmath>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SIGHT_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SIGHT_SSE2
+#endif
+
+void SightGrid::Init(const Map& map)
+{
+    rows = map.GetRow();
+    cols = map.GetCol();
+    stride = (cols + 31) >> 5;
+    bits.assign(rows * stride, 0);
+    for (int r = 0; r < rows; r++)
+        for (int c = 0; c < cols; c++)
+            if (map.IsWallUnchecked(r, c)) bits[r * stride + (c >> 5)] |= 1u << (c & 31);
+}
+
+bool SightGrid::IsWall(int row, int col) const
+{
+    if (row < 0 || row >= rows || col < 0 || col >= cols) return true;
+    return (bits[row * stride + (col >> 5)] >> (col & 31)) & 1;
+}
+
+// The DDA takes exactly |dcol| + |drow| steps from the viewer's tile to the target's; an axis stops
+// stepping once it reaches the target, so rounding near corners cannot walk past the target tile.
+bool SightGrid::CheckOne(float x, float y, float c, float s, float tx, float ty, float cosHalfFov, float maxDepth) const
+{
+    float dx = tx - x, dy = ty - y;
+    float dist2 = dx * dx + dy * dy;
+    if (dist2 > maxDepth * maxDepth) return false;
+    if (c * dx + s * dy < std::sqrt(dist2) * cosHalfFov) return false;
+
+    int cx = (int)x, cy = (int)y;
+    if (x < 0 || y < 0 || cx >= cols || cy >= rows) return false;
+    int stepX = dx < 0 ? -1 : 1, stepY = dy < 0 ? -1 : 1;
+    int remX = std::abs((int)tx - cx), remY = std::abs((int)ty - cy);
+    float deltaX = 1.0f / std::fmax(std::fabs(dx), 1e-30f);
+    float deltaY = 1.0f / std::fmax(std::fabs(dy), 1e-30f);
+    float sideX = (dx < 0 ? x - cx : cx + 1.0f - x) * deltaX;
+    float sideY = (dy < 0 ? y - cy : cy + 1.0f - y) * deltaY;
+
+    while (remX + remY > 0)
+    {
+        if (remY == 0 || (remX > 0 && sideX < sideY)) cx += stepX, sideX += deltaX, remX--;
+        else cy += stepY, sideY += deltaY, remY--;
+        if (IsWall(cy, cx)) return false;
+    }
+    return true;
+}
+
+void SightGrid::CheckSight(const float* xs, const float* ys, const float* angles, int count,
+                           float tx, float ty, float fov, float maxDepth, uint8_t* out)
+{
+    if (count <= 0) return;
+    if (IsWall((int)ty, (int)tx) || tx < 0 || ty < 0) {
+        for (int i = 0; i < count; i++) out[i] = 0;
+        return;
+    }
+    sinBuf.resize(count);
+    cosBuf.resize(count);
+    FastMath::SinCos(angles, sinBuf.data(), cosBuf.data(), count);
+    float cosHalfFov = FastMath::Cos(fov * 0.5f);
+    int i = 0;
+
+#if defined(SIGHT_AVX2)
+    const __m256 vtx = _mm256_set1_ps(tx), vty = _mm256_set1_ps(ty);
+    const __m256i tcx = _mm256_set1_epi32((int)tx), tcy = _mm256_set1_epi32((int)ty);
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    const __m256 tiny = _mm256_set1_ps(1e-30f), one = _mm256_set1_ps(1.0f), zero = _mm256_setzero_ps();
+    const __m256i ione = _mm256_set1_epi32(1), izero = _mm256_setzero_si256();
+    const __m256i vcols = _mm256_set1_epi32(cols), vrows = _mm256_set1_epi32(rows), vstride = _mm256_set1_epi32(stride);
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 x = _mm256_loadu_ps(xs + i), y = _mm256_loadu_ps(ys + i);
+        __m256 dx = _mm256_sub_ps(vtx, x), dy = _mm256_sub_ps(vty, y);
+        __m256 dist2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        __m256 dot = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(cosBuf.data() + i), dx),
+                                   _mm256_mul_ps(_mm256_loadu_ps(sinBuf.data() + i), dy));
+        __m256 ok = _mm256_and_ps(_mm256_cmp_ps(dist2, _mm256_set1_ps(maxDepth * maxDepth), _CMP_LE_OQ),
+                                  _mm256_cmp_ps(dot, _mm256_mul_ps(_mm256_sqrt_ps(dist2), _mm256_set1_ps(cosHalfFov)), _CMP_GE_OQ));
+
+        __m256i cx = _mm256_cvttps_epi32(x), cy = _mm256_cvttps_epi32(y);
+        __m256i inside = _mm256_and_si256(
+            _mm256_and_si256(_mm256_cmpgt_epi32(cx, _mm256_set1_epi32(-1)), _mm256_cmpgt_epi32(vcols, cx)),
+            _mm256_and_si256(_mm256_cmpgt_epi32(cy, _mm256_set1_epi32(-1)), _mm256_cmpgt_epi32(vrows, cy)));
+        inside = _mm256_and_si256(inside, _mm256_castps_si256(_mm256_cmp_ps(x, zero, _CMP_GE_OQ)));
+        inside = _mm256_and_si256(inside, _mm256_castps_si256(_mm256_cmp_ps(y, zero, _CMP_GE_OQ)));
+        __m256i alive = _mm256_and_si256(inside, _mm256_castps_si256(ok));
+        // Lanes outside the map are parked on (0, 0) so the gathers below stay in bounds
+        cx = _mm256_and_si256(cx, inside);
+        cy = _mm256_and_si256(cy, inside);
+
+        __m256 negX = _mm256_cmp_ps(dx, zero, _CMP_LT_OQ), negY = _mm256_cmp_ps(dy, zero, _CMP_LT_OQ);
+        __m256i stepX = _mm256_or_si256(_mm256_castps_si256(negX), ione);
+        __m256i stepY = _mm256_or_si256(_mm256_castps_si256(negY), ione);
+        __m256i remX = _mm256_and_si256(_mm256_abs_epi32(_mm256_sub_epi32(tcx, cx)), alive);
+        __m256i remY = _mm256_and_si256(_mm256_abs_epi32(_mm256_sub_epi32(tcy, cy)), alive);
+        __m256 deltaX = _mm256_div_ps(one, _mm256_max_ps(_mm256_and_ps(dx, absMask), tiny));
+        __m256 deltaY = _mm256_div_ps(one, _mm256_max_ps(_mm256_and_ps(dy, absMask), tiny));
+        __m256 fx = _mm256_sub_ps(x, _mm256_cvtepi32_ps(cx)), fy = _mm256_sub_ps(y, _mm256_cvtepi32_ps(cy));
+        __m256 sideX = _mm256_mul_ps(_mm256_blendv_ps(_mm256_sub_ps(one, fx), fx, negX), deltaX);
+        __m256 sideY = _mm256_mul_ps(_mm256_blendv_ps(_mm256_sub_ps(one, fy), fy, negY), deltaY);
+        __m256i blocked = izero;
+
+        for (;;)
+        {
+            __m256i active = _mm256_andnot_si256(blocked, _mm256_cmpgt_epi32(_mm256_add_epi32(remX, remY), izero));
+            if (_mm256_testz_si256(active, active)) break;
+            __m256i takeX = _mm256_or_si256(_mm256_cmpeq_epi32(remY, izero),
+                _mm256_and_si256(_mm256_cmpgt_epi32(remX, izero), _mm256_castps_si256(_mm256_cmp_ps(sideX, sideY, _CMP_LT_OQ))));
+            __m256i mX = _mm256_and_si256(takeX, active), mY = _mm256_andnot_si256(takeX, active);
+            cx = _mm256_add_epi32(cx, _mm256_and_si256(stepX, mX));
+            cy = _mm256_add_epi32(cy, _mm256_and_si256(stepY, mY));
+            remX = _mm256_add_epi32(remX, mX); // masks are -1
+            remY = _mm256_add_epi32(remY, mY);
+            sideX = _mm256_add_ps(sideX, _mm256_and_ps(deltaX, _mm256_castsi256_ps(mX)));
+            sideY = _mm256_add_ps(sideY, _mm256_and_ps(deltaY, _mm256_castsi256_ps(mY)));
+
+            __m256i word = _mm256_add_epi32(_mm256_mullo_epi32(cy, vstride), _mm256_srli_epi32(cx, 5));
+            __m256i cell = _mm256_i32gather_epi32((const int*)bits.data(), word, 4);
+            __m256i bit = _mm256_and_si256(_mm256_srlv_epi32(cell, _mm256_and_si256(cx, _mm256_set1_epi32(31))), ione);
+            blocked = _mm256_or_si256(blocked, _mm256_and_si256(_mm256_cmpeq_epi32(bit, ione), active));
+        }
+        __m256i visible = _mm256_andnot_si256(blocked, alive);
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(visible));
+        for (int k = 0; k < 8; k++) out[i + k] = (mask >> k) & 1;
+    }
+#elif defined(SIGHT_SSE2)
+    const __m128 vtx = _mm_set1_ps(tx), vty = _mm_set1_ps(ty);
+    const __m128i tcx = _mm_set1_epi32((int)tx), tcy = _mm_set1_epi32((int)ty);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    const __m128 tiny = _mm_set1_ps(1e-30f), one = _mm_set1_ps(1.0f), zero = _mm_setzero_ps();
+    const __m128i ione = _mm_set1_epi32(1), izero = _mm_setzero_si128();
+    const __m128i vcols = _mm_set1_epi32(cols), vrows = _mm_set1_epi32(rows);
+    alignas(16) int32_t lx[4], ly[4], lw[4];
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 x = _mm_loadu_ps(xs + i), y = _mm_loadu_ps(ys + i);
+        __m128 dx = _mm_sub_ps(vtx, x), dy = _mm_sub_ps(vty, y);
+        __m128 dist2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        __m128 dot = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(cosBuf.data() + i), dx),
+                                _mm_mul_ps(_mm_loadu_ps(sinBuf.data() + i), dy));
+        __m128 ok = _mm_and_ps(_mm_cmple_ps(dist2, _mm_set1_ps(maxDepth * maxDepth)),
+                               _mm_cmpge_ps(dot, _mm_mul_ps(_mm_sqrt_ps(dist2), _mm_set1_ps(cosHalfFov))));
+
+        __m128i cx = _mm_cvttps_epi32(x), cy = _mm_cvttps_epi32(y);
+        __m128i inside = _mm_and_si128(
+            _mm_and_si128(_mm_cmpgt_epi32(cx, _mm_set1_epi32(-1)), _mm_cmplt_epi32(cx, vcols)),
+            _mm_and_si128(_mm_cmpgt_epi32(cy, _mm_set1_epi32(-1)), _mm_cmplt_epi32(cy, vrows)));
+        inside = _mm_and_si128(inside, _mm_castps_si128(_mm_and_ps(_mm_cmpge_ps(x, zero), _mm_cmpge_ps(y, zero))));
+        __m128i alive = _mm_and_si128(inside, _mm_castps_si128(ok));
+        cx = _mm_and_si128(cx, inside);
+        cy = _mm_and_si128(cy, inside);
+
+        __m128 negX = _mm_cmplt_ps(dx, zero), negY = _mm_cmplt_ps(dy, zero);
+        __m128i stepX = _mm_or_si128(_mm_castps_si128(negX), ione);
+        __m128i stepY = _mm_or_si128(_mm_castps_si128(negY), ione);
+        // |a| without SSSE3: (a ^ sign) - sign
+        __m128i ddx = _mm_sub_epi32(tcx, cx), ddy = _mm_sub_epi32(tcy, cy);
+        __m128i sx = _mm_srai_epi32(ddx, 31), sy = _mm_srai_epi32(ddy, 31);
+        __m128i remX = _mm_and_si128(_mm_sub_epi32(_mm_xor_si128(ddx, sx), sx), alive);
+        __m128i remY = _mm_and_si128(_mm_sub_epi32(_mm_xor_si128(ddy, sy), sy), alive);
+        __m128 deltaX = _mm_div_ps(one, _mm_max_ps(_mm_and_ps(dx, absMask), tiny));
+        __m128 deltaY = _mm_div_ps(one, _mm_max_ps(_mm_and_ps(dy, absMask), tiny));
+        __m128 fx = _mm_sub_ps(x, _mm_cvtepi32_ps(cx)), fy = _mm_sub_ps(y, _mm_cvtepi32_ps(cy));
+        __m128 sideX = _mm_mul_ps(_mm_or_ps(_mm_and_ps(negX, fx), _mm_andnot_ps(negX, _mm_sub_ps(one, fx))), deltaX);
+        __m128 sideY = _mm_mul_ps(_mm_or_ps(_mm_and_ps(negY, fy), _mm_andnot_ps(negY, _mm_sub_ps(one, fy))), deltaY);
+        __m128i blocked = izero;
+
+        for (;;)
+        {
+            __m128i active = _mm_andnot_si128(blocked, _mm_cmpgt_epi32(_mm_add_epi32(remX, remY), izero));
+            if (_mm_movemask_epi8(active) == 0) break;
+            __m128i takeX = _mm_or_si128(_mm_cmpeq_epi32(remY, izero),
+                _mm_and_si128(_mm_cmpgt_epi32(remX, izero), _mm_castps_si128(_mm_cmplt_ps(sideX, sideY))));
+            __m128i mX = _mm_and_si128(takeX, active), mY = _mm_andnot_si128(takeX, active);
+            cx = _mm_add_epi32(cx, _mm_and_si128(stepX, mX));
+            cy = _mm_add_epi32(cy, _mm_and_si128(stepY, mY));
+            remX = _mm_add_epi32(remX, mX); // masks are -1
+            remY = _mm_add_epi32(remY, mY);
+            sideX = _mm_add_ps(sideX, _mm_and_ps(deltaX, _mm_castsi128_ps(mX)));
+            sideY = _mm_add_ps(sideY, _mm_and_ps(deltaY, _mm_castsi128_ps(mY)));
+
+            // SSE2 has no gather, the four word loads are scalar
+            _mm_store_si128((__m128i*)lx, cx);
+            _mm_store_si128((__m128i*)ly, cy);
+            for (int k = 0; k < 4; k++) lw[k] = -(int32_t)((bits[ly[k] * stride + (lx[k] >> 5)] >> (lx[k] & 31)) & 1);
+            blocked = _mm_or_si128(blocked, _mm_and_si128(_mm_load_si128((const __m128i*)lw), active));
+        }
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_andnot_si128(blocked, alive)));
+        for (int k = 0; k < 4; k++) out[i + k] = (mask >> k) & 1;
+    }
+#endif
+    for (; i < count; i++)
+        out[i] = CheckOne(xs[i], ys[i], cosBuf[i], sinBuf[i], tx, ty, cosHalfFov, maxDepth);
+}
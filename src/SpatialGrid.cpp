@@ -0,0 +1,96 @@
+#include "SpatialGrid.h"
+#include <algorithm>
+#include <cmath>
+
+void SpatialGrid::Init(int r, int c)
+{
+    if (r == rows && c == cols && !cellStart.empty()) return;
+    rows = std::max(r, 1);
+    cols = std::max(c, 1);
+    cellStart.assign(rows * cols + 1, 0);
+    items.clear();
+    itemCell.clear();
+}
+
+int SpatialGrid::CellOf(float x, float y) const
+{
+    // Anything outside the map is kept in the border buckets
+    int col = std::clamp((int)x, 0, cols - 1);
+    int row = std::clamp((int)y, 0, rows - 1);
+    return row * cols + col;
+}
+
+void SpatialGrid::Begin(int count)
+{
+    itemCell.assign(count, -1);
+}
+
+void SpatialGrid::Insert(int index, float x, float y)
+{
+    if (index < 0 || index >= (int)itemCell.size()) return;
+    itemCell[index] = CellOf(x, y);
+}
+
+void SpatialGrid::End()
+{
+    // Counting sort: histogram, exclusive prefix sum, then scatter
+    std::fill(cellStart.begin(), cellStart.end(), 0);
+    int total = 0;
+    for (int cell : itemCell)
+        if (cell >= 0) { cellStart[cell + 1]++; total++; }
+    for (size_t i = 1; i < cellStart.size(); i++) cellStart[i] += cellStart[i - 1];
+
+    items.resize(total);
+    cursor.assign(cellStart.begin(), cellStart.end() - 1);
+    for (int i = 0; i < (int)itemCell.size(); i++)
+        if (itemCell[i] >= 0) items[cursor[itemCell[i]]++] = i;
+}
+
+void SpatialGrid::QueryAABB(float minX, float minY, float maxX, float maxY, std::vector<int>& out) const
+{
+    if (cellStart.empty()) return;
+    int c0 = std::clamp((int)std::floor(minX), 0, cols - 1);
+    int c1 = std::clamp((int)std::floor(maxX), 0, cols - 1);
+    int r0 = std::clamp((int)std::floor(minY), 0, rows - 1);
+    int r1 = std::clamp((int)std::floor(maxY), 0, rows - 1);
+
+    for (int r = r0; r <= r1; r++)
+    {
+        // Buckets of one row are adjacent, so the whole span is a single range
+        int begin = cellStart[r * cols + c0];
+        int end = cellStart[r * cols + c1 + 1];
+        out.insert(out.end(), items.begin() + begin, items.begin() + end);
+    }
+}
+
+void SpatialGrid::QueryRadius(float x, float y, float radius, std::vector<int>& out) const
+{
+    if (cellStart.empty()) return;
+    int c0 = std::clamp((int)std::floor(x - radius), 0, cols - 1);
+    int c1 = std::clamp((int)std::floor(x + radius), 0, cols - 1);
+    int r0 = std::clamp((int)std::floor(y - radius), 0, rows - 1);
+    int r1 = std::clamp((int)std::floor(y + radius), 0, rows - 1);
+    float r2 = radius * radius;
+
+    for (int r = r0; r <= r1; r++)
+    {
+        for (int c = c0; c <= c1; c++)
+        {
+            // Skip corner buckets the circle does not reach; border buckets also hold
+            // out-of-map items, so they are never skipped
+            bool border = r == 0 || c == 0 || r == rows - 1 || c == cols - 1;
+            float nx = std::clamp(x, (float)c, (float)(c + 1)) - x;
+            float ny = std::clamp(y, (float)r, (float)(r + 1)) - y;
+            if (!border && nx * nx + ny * ny > r2) continue;
+
+            int cell = r * cols + c;
+            out.insert(out.end(), items.begin() + cellStart[cell], items.begin() + cellStart[cell + 1]);
+        }
+    }
+}
+
+int SpatialGrid::GetCellOf(int index) const
+{
+    if (index < 0 || index >= (int)itemCell.size()) return -1;
+    return itemCell[index];
+}
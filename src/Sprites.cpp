@@ -1,121 +1,113 @@
 #include "Sprites.h"
 
-Sprites::Sprites(float x, float y, float a, float s, float rs, bool rg, bool vs, int defaultState, int index, std::string n, float hp, float dm, float rag)
-    :posx(x), posy(y), angle(a), speed(s), rot_speed(rs), rigid(rg), visible(vs), DEFAULTSTATE(defaultState), texid(index), name(n), HP(hp), damage(dm), range(rag)
-{AniDone = true, AniFrame_delay = 0, state = DEFAULTSTATE, dead = false;}
+int Sprites::Add(int enemyType, float x, float y, float a)
+{
+    const EnemyTypeInfo& info = GetEnemyType(enemyType);
+    posX.push_back(x); posY.push_back(y);
+    prevX.push_back(x); prevY.push_back(y);
+    prevAngle.push_back(a); angle.push_back(a);
+    velX.push_back(0); velY.push_back(0);
+    hp.push_back(info.hp);
+    state.push_back((uint8_t)info.defaultState);
+    aniCnt.push_back(0); aniDelay.push_back(0);
+    flags.push_back(SPRITE_RIGID | SPRITE_VISIBLE | SPRITE_ANI_DONE);
+    type.push_back((uint8_t)enemyType);
+    return Size() - 1;
+}
 
-int Sprites::GetDirIndex(float playerX, float playerY, float playerAngle, int numDirections) const
+void Sprites::Clear()
 {
-    float dx = playerX - posx;
-    float dy = playerY - posy;
-    float angleToPlayer = atan2(dy, dx);
-    if (angleToPlayer < 0) angleToPlayer += 2*M_PI;
-    float relativeAngle = angleToPlayer - angle;  // sprite.angle
-    relativeAngle = fmod(relativeAngle + 2*M_PI, 2*M_PI);
-
-    int frame = int(relativeAngle / (2*M_PI / numDirections)) % numDirections;
-    return frame;
+    posX.clear(); posY.clear(); prevX.clear(); prevY.clear(); prevAngle.clear(); angle.clear();
+    velX.clear(); velY.clear(); hp.clear(); state.clear();
+    aniCnt.clear(); aniDelay.clear(); flags.clear(); type.clear();
 }
 
-bool Sprites::CheckRigid() const {return rigid;}
+int Sprites::Size() const {return (int)posX.size();}
 
-bool Sprites::CheckVisible() const {return visible;}
+bool Sprites::IsDead(int i) const {return flags[i] & SPRITE_DEAD;}
 
-float Sprites::GetOldX() const {return oldx;}
+bool Sprites::IsRigid(int i) const {return flags[i] & SPRITE_RIGID;}
 
-float Sprites::GetOldY() const {return oldy;}
+bool Sprites::IsVisible(int i) const {return flags[i] & SPRITE_VISIBLE;}
 
-float Sprites::GetX() const {return posx;}
+bool Sprites::CheckAni(int i) const {return flags[i] & SPRITE_ANI_DONE;}
 
-float Sprites::GetY() const {return posy;}
+int Sprites::CountDead() const
+{
+    int cnt = 0;
+    for (uint8_t f : flags) cnt += (f & SPRITE_DEAD) != 0;
+    return cnt;
+}
 
-float Sprites::GetA() const {return angle;}
+int Sprites::GetDefaultState(int i) const {return GetEnemyType(type[i]).defaultState;}
 
-int Sprites::GetState() const {return state;}
+const EnemyTypeInfo& Sprites::GetInfo(int i) const {return GetEnemyType(type[i]);}
 
-int Sprites::GetTexID() const {return texid;}
+int Sprites::DirIndex(float spriteX, float spriteY, float spriteAngle, float viewX, float viewY, int numDirections)
+{
+    float dx = viewX - spriteX;
+    float dy = viewY - spriteY;
+    // Binary angles wrap for free, so the relative angle needs no normalization
+    FastMath::BAngle relativeAngle = FastMath::ToBAngle(FastMath::Atan2(dy, dx)) - FastMath::ToBAngle(spriteAngle);
+    return (int)(((uint32_t)relativeAngle * numDirections) >> 16);
+}
 
-int Sprites::GetAniCnt() const {return AniFrame_counter;}
+void Sprites::SetState(int i, int s)
+{
+    if (s == state[i]) return;
+    if (state[i] == 5) return;
+
+    state[i] = (uint8_t)s;
+    aniCnt[i] = 0;
+    aniDelay[i] = 0;
+    if (s < 2) flags[i] |= SPRITE_ANI_DONE;
+    else flags[i] &= ~SPRITE_ANI_DONE;
+}
 
-void Sprites::SetTexID(int id) {texid = id;}
+void Sprites::SetVelocity(int i, float vx, float vy) {velX[i] = vx, velY[i] = vy;}
 
-void Sprites::SetState(int s)
+void Sprites::Rotate(int i, float deltaAngle)
 {
-    if (s == state) return;
-    if (state == 5) return;
+    float a = std::fmod(angle[i] + deltaAngle, 2 * PI);
+    angle[i] = a < 0 ? a + 2 * PI : a;
+}
 
-    state = s;
-    AniFrame_counter = 0;
-    AniFrame_delay = 0;
-    AniDone = (s < 2);
+void Sprites::TakeDamage(int i, float amount)
+{
+    if(!(state[i] == 4 && !CheckAni(i)) && state[i] != 5) SetState(i, 4);
+    hp[i] -= amount;
+    if(hp[i] <= 0) flags[i] = (flags[i] | SPRITE_DEAD) & ~SPRITE_RIGID;
 }
 
-void Sprites::UpdateAnimation()
+void Sprites::UpdateAnimation(int i)
 {
-    if (AniDone) return;
-    int temp[4];
-    if(name == "cacodemon") temp[0] = 3, temp[1] = 5, temp[2] = 2, temp[3] = 6;
-    if(name == "cyberdemon") temp[0] = 4, temp[1] = 2, temp[2] = 2, temp[3] = 9;
-    AniFrame_delay++;
-    if(state == 2 && AniFrame_delay >= St2Delay) { AniFrame_counter++; AniFrame_delay = 0; }
-    if(state == 3 && AniFrame_delay >= St3Delay) { AniFrame_counter++; AniFrame_delay = 0; }
-    if(state == 4 && AniFrame_delay >= St4Delay) { AniFrame_counter++; AniFrame_delay = 0; }
-    if(state == 5 && AniFrame_delay >= St5Delay) { AniFrame_counter++; AniFrame_delay = 0; }
-
-    bool animationJustFinished = false;
-    if(state == 2 && AniFrame_counter > temp[0]) animationJustFinished = true;
-    if(state == 3 && AniFrame_counter > temp[1]) animationJustFinished = true;
-    if(state == 4 && AniFrame_counter > temp[2]) animationJustFinished = true;
-
-    if(state == 5 && AniFrame_counter > temp[3])
+    int s = state[i];
+    if (CheckAni(i) || s < 2 || s >= STATE_COUNT) return;
+    const EnemyTypeInfo& info = GetInfo(i);
+    int frames = info.frames[s];
+
+    aniDelay[i]++;
+    if(aniDelay[i] >= info.frameDelay[s]) { aniCnt[i]++; aniDelay[i] = 0; }
+
+    if(s == 5 && aniCnt[i] > frames)
     {
-        AniFrame_counter = temp[3];
-        AniDone = true;
+        aniCnt[i] = (uint8_t)frames;
+        flags[i] |= SPRITE_ANI_DONE;
         return;
     }
 
-    if (animationJustFinished) {
-        SetState(DEFAULTSTATE);
-    }
+    if (s != 5 && aniCnt[i] > frames) SetState(i, info.defaultState);
 }
 
-void Sprites::UpdateSprite()
+void Sprites::UpdateStates()
 {
-    if (IsDead() && GetState() != 5)
+    for (int i = 0; i < Size(); i++)
     {
-        SetState(5);
+        if (IsDead(i) && state[i] != 5) SetState(i, 5);
+        UpdateAnimation(i);
     }
-    UpdateAnimation();
 }
 
-bool Sprites::CheckAni() {return AniDone;}
-
-void Sprites::ChangePos(std::pair<float, float> pos)
-{
-    oldx = posx;
-    oldy = posy;
-    posx = pos.first;
-    posy = pos.second;
-}
-
-void Sprites::Rotate(float deltaAngle)
-{
-    angle += deltaAngle;
-    angle = std::fmod(angle, 2 * PI);
-    if(angle < 0) angle += 2 * PI;
-}
-
-float Sprites::GetS() const {return speed;}
-
-void Sprites::TakeDamage(float amount)
-{
-    if(!(GetState() == 4 && !CheckAni()) && GetState() != 5) SetState(4);
-    HP -= amount;
-    if(HP <= 0) dead = true, rigid = false;
-}
-
-bool Sprites::IsDead() const { return dead;}
-
-int Sprites::GetDefaultState() {return DEFAULTSTATE;}
+void Sprites::UpdateAnimations() {for (int i = 0; i < Size(); i++) UpdateAnimation(i);}
 
-int Sprites::GetR() const {return rot_speed;}
+void Sprites::SavePoses() {prevX = posX, prevY = posY, prevAngle = angle;}
@@ -0,0 +1,140 @@
+#include "TextRenderer.h"
+#include <iostream>
+#include <algorithm>
+
+bool TextRenderer::Init(SDL_Renderer* rd, const std::string& fontPath, int ptSize)
+{
+    renderer = rd;
+    if (TTF_Init() < 0) {
+        std::cerr << "TTF_Init failed: " << TTF_GetError() << "\n";
+        return false;
+    }
+    font = TTF_OpenFont(fontPath.c_str(), ptSize);
+    if (!font) {
+        std::cerr << "Failed to load font: " << TTF_GetError() << std::endl;
+        TTF_Quit();
+        return false;
+    }
+    lineHeight = TTF_FontLineSkip(font);
+
+    // Rasterize every glyph once and shelf-pack them into rows of the atlas
+    const int glyphCount = TEXT_LAST_GLYPH - TEXT_FIRST_GLYPH + 1;
+    SDL_Color white = {255, 255, 255, 255};
+    std::vector<SDL_Surface*> surfs(glyphCount, nullptr);
+    int penX = 0, penY = 0, rowH = 0;
+    for (int i = 0; i < glyphCount; i++)
+    {
+        Uint32 ch = TEXT_FIRST_GLYPH + i;
+        int minx, maxx, miny, maxy, advance = 0;
+        TTF_GlyphMetrics32(font, ch, &minx, &maxx, &miny, &maxy, &advance);
+        glyphs[i] = {{0, 0, 0, 0}, advance};
+        surfs[i] = TTF_RenderGlyph32_Blended(font, ch, white);
+        if (!surfs[i]) continue;
+        if (penX + surfs[i]->w > TEXT_ATLAS_WIDTH) penX = 0, penY += rowH + 1, rowH = 0;
+        glyphs[i].src = {penX, penY, surfs[i]->w, surfs[i]->h};
+        penX += surfs[i]->w + 1;
+        rowH = std::max(rowH, surfs[i]->h);
+    }
+    atlasW = TEXT_ATLAS_WIDTH, atlasH = penY + rowH;
+
+    SDL_Surface* sheet = SDL_CreateRGBSurfaceWithFormat(0, atlasW, std::max(atlasH, 1), 32, SDL_PIXELFORMAT_ARGB8888);
+    if (sheet)
+    {
+        SDL_FillRect(sheet, NULL, 0);
+        for (int i = 0; i < glyphCount; i++)
+        {
+            if (!surfs[i]) continue;
+            SDL_SetSurfaceBlendMode(surfs[i], SDL_BLENDMODE_NONE);
+            SDL_BlitSurface(surfs[i], NULL, sheet, &glyphs[i].src);
+        }
+        atlas = SDL_CreateTextureFromSurface(renderer, sheet);
+        SDL_FreeSurface(sheet);
+    }
+    for (SDL_Surface* s : surfs) if (s) SDL_FreeSurface(s);
+    if (!atlas) {
+        std::cerr << "Failed to build glyph atlas: " << SDL_GetError() << std::endl;
+        CleanUp();
+        return false;
+    }
+    SDL_SetTextureBlendMode(atlas, SDL_BLENDMODE_BLEND);
+    return true;
+}
+
+void TextRenderer::CleanUp()
+{
+    if (atlas) SDL_DestroyTexture(atlas);
+    if (font)
+    {
+        TTF_CloseFont(font);
+        TTF_Quit();
+    }
+    atlas = nullptr, font = nullptr;
+    cache.clear();
+    verts.clear();
+    indices.clear();
+}
+
+bool TextRenderer::IsReady() const {return atlas != nullptr;}
+
+int TextRenderer::GetLineHeight() const {return lineHeight;}
+
+const TextRenderer::Layout& TextRenderer::GetLayout(const std::string& text)
+{
+    auto it = cache.find(text);
+    if (it != cache.end()) return it->second;
+    if (cache.size() >= TEXT_CACHE_MAX) cache.clear(); // changing strings (timers, counters) would grow it forever
+
+    Layout& out = cache[text];
+    float invW = 1.0f / atlasW, invH = 1.0f / atlasH;
+    int penX = 0;
+    Uint32 prev = 0;
+    for (unsigned char c : text)
+    {
+        Uint32 ch = (c < TEXT_FIRST_GLYPH || c > TEXT_LAST_GLYPH) ? '?' : c;
+        if (prev) penX += TTF_GetFontKerningSizeGlyphs32(font, prev, ch);
+        prev = ch;
+        const Glyph& g = glyphs[ch - TEXT_FIRST_GLYPH];
+        if (g.src.w > 0)
+        {
+            float x0 = (float)penX, x1 = (float)(penX + g.src.w), y1 = (float)g.src.h;
+            float u0 = g.src.x * invW, u1 = (g.src.x + g.src.w) * invW;
+            float v0 = g.src.y * invH, v1 = (g.src.y + g.src.h) * invH;
+            out.pos.insert(out.pos.end(), {{x0, 0.0f}, {x1, 0.0f}, {x1, y1}, {x0, y1}});
+            out.uv.insert(out.uv.end(), {{u0, v0}, {u1, v0}, {u1, v1}, {u0, v1}});
+        }
+        penX += g.advance;
+    }
+    out.width = penX;
+    return out;
+}
+
+int TextRenderer::Measure(const std::string& text)
+{
+    if (!atlas) return 0;
+    return GetLayout(text).width;
+}
+
+void TextRenderer::Draw(const std::string& text, int x, int y, SDL_Color color, TextAlign align)
+{
+    if (!atlas || text.empty()) return;
+    const Layout& l = GetLayout(text);
+    if (align == TEXT_CENTER) x -= l.width / 2;
+    else if (align == TEXT_RIGHT) x -= l.width;
+
+    int base = (int)verts.size();
+    for (size_t k = 0; k < l.pos.size(); k++)
+        verts.push_back({{l.pos[k].x + x, l.pos[k].y + y}, color, l.uv[k]});
+    for (int q = base; q < (int)verts.size(); q += 4)
+    {
+        const int quad[6] = {0, 1, 2, 0, 2, 3};
+        for (int k : quad) indices.push_back(q + k);
+    }
+}
+
+void TextRenderer::Flush()
+{
+    if (!atlas || indices.empty()) return;
+    SDL_RenderGeometry(renderer, atlas, verts.data(), (int)verts.size(), indices.data(), (int)indices.size());
+    verts.clear();
+    indices.clear();
+}
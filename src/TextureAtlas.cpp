@@ -0,0 +1,48 @@
+#include "TextureAtlas.h"
+
+int TextureAtlas::Add(SDL_Surface* argb)
+{
+    AtlasEntry e;
+    e.offset = texels.size();
+    e.w = argb->w;
+    e.h = argb->h;
+    e.frames.push_back({0, 0, e.w, e.h});
+    texels.resize(e.offset + (size_t)e.w * e.h);
+
+    SDL_LockSurface(argb);
+    const Uint32* src = (const Uint32*)argb->pixels;
+    int pitch = argb->pitch / sizeof(Uint32);
+    Uint32* dst = &texels[e.offset];
+    for (int y = 0; y < e.h; y++)
+        for (int x = 0; x < e.w; x++)
+            dst[(size_t)x * e.h + y] = src[y * pitch + x];
+    SDL_UnlockSurface(argb);
+
+    entries.push_back(e);
+    return (int)entries.size() - 1;
+}
+
+void TextureAtlas::SetFrames(int id, int frameCount)
+{
+    if (id < 0 || id >= (int)entries.size() || frameCount < 1) return;
+    AtlasEntry& e = entries[id];
+    int frameW = e.w / frameCount;
+    e.frames.clear();
+    for (int i = 0; i < frameCount; i++) e.frames.push_back({i * frameW, 0, frameW, e.h});
+}
+
+const SDL_Rect& TextureAtlas::GetFrame(int id, int frame) const
+{
+    const AtlasEntry& e = entries[id];
+    if (frame < 0) frame = 0;
+    if (frame >= (int)e.frames.size()) frame = (int)e.frames.size() - 1;
+    return e.frames[frame];
+}
+
+void TextureAtlas::Clear()
+{
+    texels.clear();
+    entries.clear();
+}
+
+int TextureAtlas::Size() const {return (int)entries.size();}
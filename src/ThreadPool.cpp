@@ -0,0 +1,93 @@
+#include "ThreadPool.h"
+#include <iostream>
+#include <algorithm>
+
+bool ThreadPool::Init(int threadCount, bool quiet)
+{
+    if (threadCount <= 0) threadCount = (int)std::thread::hardware_concurrency();
+    if (threadCount <= 0) threadCount = 1;
+
+    // The caller of ParallelFor is one of the workers, so spawn one less
+    for (int i = 0; i < threadCount - 1; i++)
+        workers.emplace_back(&ThreadPool::WorkerLoop, this);
+
+    if (!quiet) std::cout << "ThreadPool started with " << threadCount << " threads" << std::endl;
+    return true;
+}
+
+void ThreadPool::RunChunks()
+{
+    while (true)
+    {
+        int begin = nextChunk.fetch_add(chunkSize);
+        if (begin >= jobCount) break;
+        int end = std::min(begin + chunkSize, jobCount);
+        (*job)(begin, end);
+    }
+}
+
+void ThreadPool::WorkerLoop()
+{
+    unsigned int seen = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            wakeCv.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+
+        RunChunks();
+
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            finishedWorkers++;
+        }
+        doneCv.notify_one();
+    }
+}
+
+void ThreadPool::ParallelFor(int count, const std::function<void(int begin, int end)>& fn)
+{
+    if (count <= 0) return;
+    if (workers.empty())
+    {
+        fn(0, count);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        job = &fn;
+        jobCount = count;
+        // A few chunks per thread keeps the load balanced when columns differ in cost
+        int chunks = (int)(workers.size() + 1) * 4;
+        chunkSize = std::max(1, (count + chunks - 1) / chunks);
+        nextChunk.store(0);
+        finishedWorkers = 0;
+        generation++;
+    }
+    wakeCv.notify_all();
+
+    RunChunks();
+
+    std::unique_lock<std::mutex> lock(mtx);
+    // Every worker checks in once per call, so none can still be holding this job afterwards
+    doneCv.wait(lock, [&] { return finishedWorkers == workers.size(); });
+    job = nullptr;
+}
+
+int ThreadPool::GetThreadCount() const {return (int)workers.size() + 1;}
+
+void ThreadPool::CleanUp()
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    wakeCv.notify_all();
+    for (auto& t : workers) t.join();
+    workers.clear();
+    stopping = false; // Init may start the pool again
+}
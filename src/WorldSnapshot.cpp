@@ -0,0 +1,17 @@
+#include "WorldSnapshot.h"
+
+void SnapshotBuffer::Publish()
+{
+    int prev = shared.exchange(back | FRESH, std::memory_order_acq_rel);
+    back = prev & 3;
+}
+
+const WorldSnapshot& SnapshotBuffer::Acquire()
+{
+    if (shared.load(std::memory_order_relaxed) & FRESH)
+    {
+        int prev = shared.exchange(front, std::memory_order_acq_rel);
+        front = prev & 3;
+    }
+    return slots[front];
+}